@@ -0,0 +1,85 @@
+#include "AsyncTrajectoryWriter.h"
+
+AsyncTrajectoryWriter::AsyncTrajectoryWriter(std::unique_ptr<TrajectoryWriter> inner_,
+                                             std::size_t depth)
+    : inner(std::move(inner_)),
+    frames(depth < 1 ? 1 : depth),
+    current(nullptr),
+    finishing(false)
+{
+    for (StepFrame& f : frames) {
+        freeFrames.push_back(&f);
+    }
+}
+
+AsyncTrajectoryWriter::~AsyncTrajectoryWriter() {
+    close();
+}
+
+bool AsyncTrajectoryWriter::open(const std::string& path) {
+    if (!inner->open(path)) return false;
+    finishing = false;
+    worker = std::thread(&AsyncTrajectoryWriter::workerLoop, this);
+    return true;
+}
+
+void AsyncTrajectoryWriter::writeHeader(std::size_t numParticles, double dt,
+                                        double totalTime, const Box& box) {
+    // Todavía no hay pasos en cola: el hilo no toca 'inner' hasta recibir uno
+    inner->writeHeader(numParticles, dt, totalTime, box);
+}
+
+StepFrame& AsyncTrajectoryWriter::beginStep() {
+    std::unique_lock<std::mutex> lock(mutex);
+    frameFree.wait(lock, [this] { return !freeFrames.empty(); });
+    current = freeFrames.front();
+    freeFrames.pop_front();
+    return *current;
+}
+
+void AsyncTrajectoryWriter::commitStep() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyFrames.push_back(current);
+        current = nullptr;
+    }
+    frameReady.notify_one();
+}
+
+void AsyncTrajectoryWriter::writeStep(const StepFrame& frame) {
+    beginStep() = frame;
+    commitStep();
+}
+
+void AsyncTrajectoryWriter::workerLoop() {
+    for (;;) {
+        StepFrame* f;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait(lock, [this] { return finishing || !readyFrames.empty(); });
+            if (readyFrames.empty()) return; // finishing y no queda nada
+            f = readyFrames.front();
+            readyFrames.pop_front();
+        }
+
+        inner->writeStep(*f);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeFrames.push_back(f);
+        }
+        frameFree.notify_one();
+    }
+}
+
+void AsyncTrajectoryWriter::close() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishing = true;
+        }
+        frameReady.notify_one();
+        worker.join();
+    }
+    inner->close();
+}
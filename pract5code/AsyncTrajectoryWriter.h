@@ -0,0 +1,54 @@
+#ifndef ASYNCTRAJECTORYWRITER_H
+#define ASYNCTRAJECTORYWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TrajectoryWriter.h"
+
+// Escritor en segundo plano. La simulación llena frames preasignados y un
+// hilo aparte los formatea y los escribe con el escritor 'inner'. Hay
+// 'depth' frames (2 = doble buffer): si están todos ocupados beginStep()
+// espera, así la memoria queda acotada aunque el disco sea lento.
+//
+// Los pasos se escriben en el mismo orden y con el mismo escritor, así que
+// el archivo queda idéntico al de la escritura síncrona.
+class AsyncTrajectoryWriter : public TrajectoryWriter {
+public:
+    explicit AsyncTrajectoryWriter(std::unique_ptr<TrajectoryWriter> inner,
+                                   std::size_t depth = 2);
+    ~AsyncTrajectoryWriter() override;
+
+    bool open(const std::string& path) override;
+    void writeHeader(std::size_t numParticles, double dt,
+                     double totalTime, const Box& box) override;
+
+    StepFrame& beginStep() override;
+    void commitStep() override;
+    void writeStep(const StepFrame& frame) override;
+
+    void close() override;
+    std::uint64_t bytesWritten() const override { return inner->bytesWritten(); }
+    bool needsFrames() const override { return inner->needsFrames(); }
+
+private:
+    std::unique_ptr<TrajectoryWriter> inner;
+    std::vector<StepFrame> frames;
+
+    std::mutex mutex;
+    std::condition_variable frameFree;
+    std::condition_variable frameReady;
+    std::deque<StepFrame*> freeFrames;
+    std::deque<StepFrame*> readyFrames;
+    StepFrame* current;
+    bool finishing;
+
+    std::thread worker;
+
+    void workerLoop();
+};
+
+#endif // ASYNCTRAJECTORYWRITER_H
@@ -1,5 +1,6 @@
 #include "Box.h"
-#include "Particle.h"
+#include "ParticleStore.h"
+#include "SimdKernels.h"
 
 using namespace std;
 
@@ -8,35 +9,33 @@ Box::Box(double w, double h)
 {
 }
 
-bool Box::handleWallCollision(Particle& p, std::ofstream& log, double time) {
-    if (!p.active) return false;
-    bool collided = false;
-
-    // Paredes izquierda y derecha (x=0 y x=width)
-    if (p.position.x - p.radius < 0.0) {
-        p.position.x = p.radius; // Corrige penetración
-        p.velocity.x = -p.velocity.x;
-        log << "COLLISION " << time << " " << p.id << " MURO_IZQ\n";
-        collided = true;
-    } else if (p.position.x + p.radius > width) {
-        p.position.x = width - p.radius;
-        p.velocity.x = -p.velocity.x;
-        log << "COLLISION " << time << " " << p.id << " MURO_DER\n";
-        collided = true;
+void Box::reflectWalls(ParticleStore& s, std::size_t begin, std::size_t end,
+                       WallHits& hits) const {
+    if (hits.index.size() < end - begin) {
+        hits.index.resize(end - begin);
+        hits.mask.resize(end - begin);
     }
+    hits.count = kernels::reflectWalls(s.x.data(), s.y.data(), s.vx.data(), s.vy.data(),
+                                       s.radius.data(), begin, end,
+                                       static_cast<Scalar>(width),
+                                       static_cast<Scalar>(height),
+                                       hits.index.data(), hits.mask.data());
+}
 
-    // Paredes inferior y superior (y=0 y y=height)
-    if (p.position.y - p.radius < 0.0) {
-        p.position.y = p.radius;
-        p.velocity.y = -p.velocity.y;
-        log << "COLLISION " << time << " " << p.id << " MURO_ABAJ\n";
-        collided = true;
-    } else if (p.position.y + p.radius > height) {
-        p.position.y = height - p.radius;
-        p.velocity.y = -p.velocity.y;
-        log << "COLLISION " << time << " " << p.id << " MURO_ARR\n";
-        collided = true;
-    }
+void Box::appendWallEvents(const ParticleStore& s, const WallHits& hits,
+                           double time, std::vector<CollisionEvent>& events) {
+    for (std::size_t k = 0; k < hits.count; ++k) {
+        int id = s.id[hits.index[k]];
+        std::uint8_t mask = hits.mask[k];
 
-    return collided;
+        if (mask & kernels::HitLeft)
+            events.push_back({time, CollisionKind::WallLeft, id, -1, -1});
+        else if (mask & kernels::HitRight)
+            events.push_back({time, CollisionKind::WallRight, id, -1, -1});
+
+        if (mask & kernels::HitBottom)
+            events.push_back({time, CollisionKind::WallBottom, id, -1, -1});
+        else if (mask & kernels::HitTop)
+            events.push_back({time, CollisionKind::WallTop, id, -1, -1});
+    }
 }
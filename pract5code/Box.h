@@ -1,12 +1,23 @@
 #ifndef BOX_H
 #define BOX_H
 
-#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CollisionEvent.h"
+#include "ParticleStore.h"
 
 using namespace std;
 
 
-class Particle;
+
+// Partículas que tocaron una pared en un lote: slot y paredes tocadas
+// (bits de kernels::WallBits), en orden creciente de slot
+struct WallHits {
+    std::vector<std::uint32_t> index;
+    std::vector<std::uint8_t> mask;
+    std::size_t count = 0;
+};
 
 
 class Box
@@ -17,8 +28,14 @@ public:
 
     Box(double w, double h);
 
-    // maneja la colisopn con paredes, escribe en el log si ocurre
-    bool handleWallCollision(Particle& p, ofstream& log, double time);
+    // maneja la colisopn con paredes de las partículas en [begin, end);
+    // no escribe eventos, deja en 'hits' cuáles chocaron
+    void reflectWalls(ParticleStore& s, std::size_t begin, std::size_t end,
+                      WallHits& hits) const;
+
+    // Agrega los eventos de 'hits' (MURO_IZQ/DER antes que MURO_ABAJ/ARR)
+    static void appendWallEvents(const ParticleStore& s, const WallHits& hits,
+                                 double time, std::vector<CollisionEvent>& events);
 };
 
 #endif // BOX_H
@@ -0,0 +1,216 @@
+#include "Checkpoint.h"
+#include "Simulation.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char kMagic[8] = {'P', '5', 'C', 'K', 'P', 'T', 0, 0};
+const std::uint32_t kVersion = 1;
+
+struct CheckpointHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t scalarBytes;  // sizeof(Scalar) del programa que lo escribió
+    double width;
+    double height;
+    double dt;
+    double totalTime;
+    double restitution;
+    std::int64_t nextStep;
+    std::uint64_t numParticles;
+    std::uint64_t numObstacles;
+};
+static_assert(sizeof(CheckpointHeader) == 80, "cabecera de 80 bytes");
+
+// Una partícula, en orden de inserción
+struct CheckpointParticle {
+    double x, y, vx, vy, mass, radius;
+    std::int32_t id;
+    std::uint8_t active;
+    std::uint8_t padding[3];
+};
+static_assert(sizeof(CheckpointParticle) == 56, "registro de 56 bytes");
+
+struct CheckpointObstacle {
+    double cx, cy, halfSize;
+};
+
+// FNV-1a de 64 bits; detecta archivos cortados o dañados
+std::uint64_t checksum(const void* data, std::size_t bytes, std::uint64_t h) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < bytes; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+const std::uint64_t kChecksumSeed = 1469598103934665603ULL;
+
+} // namespace
+
+bool saveCheckpoint(const Simulation& sim, int nextStep,
+                    const std::string& path, std::string& error) {
+    CheckpointHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(h.magic));
+    h.version = kVersion;
+    h.scalarBytes = sizeof(Scalar);
+    h.width = sim.box.width;
+    h.height = sim.box.height;
+    h.dt = sim.dt;
+    h.totalTime = sim.totalTime;
+    h.restitution = sim.obstacleRestitution;
+    h.nextStep = nextStep;
+    h.numParticles = sim.particles.size();
+    h.numObstacles = sim.obstacles.size();
+
+    const ParticleStore& s = sim.particles;
+    std::vector<CheckpointParticle> particles;
+    particles.reserve(s.size());
+    s.forEachInOrder([&](std::size_t slot) {
+        CheckpointParticle p;
+        std::memset(&p, 0, sizeof(p));
+        p.x = s.x[slot];
+        p.y = s.y[slot];
+        p.vx = s.vx[slot];
+        p.vy = s.vy[slot];
+        p.mass = s.mass[slot];
+        p.radius = s.radius[slot];
+        p.id = s.id[slot];
+        p.active = s.active[slot];
+        particles.push_back(p);
+    });
+
+    std::vector<CheckpointObstacle> obstacles;
+    obstacles.reserve(sim.obstacles.size());
+    for (const Obstacle& o : sim.obstacles) {
+        obstacles.push_back({o.center.x, o.center.y, o.halfSize});
+    }
+
+    std::size_t particleBytes = particles.size() * sizeof(CheckpointParticle);
+    std::size_t obstacleBytes = obstacles.size() * sizeof(CheckpointObstacle);
+    std::uint64_t sum = checksum(&h, sizeof(h), kChecksumSeed);
+    sum = checksum(particles.data(), particleBytes, sum);
+    sum = checksum(obstacles.data(), obstacleBytes, sum);
+
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "no se pudo abrir " + tmpPath;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(particles.data()),
+                  static_cast<std::streamsize>(particleBytes));
+        out.write(reinterpret_cast<const char*>(obstacles.data()),
+                  static_cast<std::streamsize>(obstacleBytes));
+        out.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+        out.flush();
+        if (!out) {
+            error = "error al escribir " + tmpPath;
+            return false;
+        }
+    }
+
+    // rename() no reemplaza un archivo existente en Windows
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        error = "no se pudo renombrar " + tmpPath + " a " + path;
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const std::string& path, Simulation& sim, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    CheckpointHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+        error = "archivo demasiado corto";
+        return false;
+    }
+    if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0) {
+        error = "no es un punto de control";
+        return false;
+    }
+    if (h.version != kVersion) {
+        error = "versión de punto de control no soportada";
+        return false;
+    }
+    // Seguir en otra precisión no daría una continuación idéntica
+    if (h.scalarBytes != sizeof(Scalar)) {
+        error = "el punto de control es de una compilación con otra precisión";
+        return false;
+    }
+
+    // Las cantidades de la cabecera tienen que entrar en el archivo antes
+    // de reservar memoria para ellas
+    in.seekg(0, std::ios::end);
+    std::uint64_t fileBytes = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(sizeof(h), std::ios::beg);
+    std::uint64_t bodyBytes = fileBytes - sizeof(h);
+    if (h.numParticles > bodyBytes / sizeof(CheckpointParticle) ||
+        h.numObstacles > bodyBytes / sizeof(CheckpointObstacle) ||
+        h.numParticles * sizeof(CheckpointParticle) +
+            h.numObstacles * sizeof(CheckpointObstacle) + sizeof(std::uint64_t) != bodyBytes) {
+        error = "el tamaño del archivo no coincide con la cabecera";
+        return false;
+    }
+
+    std::vector<CheckpointParticle> particles(h.numParticles);
+    std::vector<CheckpointObstacle> obstacles(h.numObstacles);
+    std::size_t particleBytes = particles.size() * sizeof(CheckpointParticle);
+    std::size_t obstacleBytes = obstacles.size() * sizeof(CheckpointObstacle);
+    std::uint64_t stored = 0;
+    in.read(reinterpret_cast<char*>(particles.data()),
+            static_cast<std::streamsize>(particleBytes));
+    in.read(reinterpret_cast<char*>(obstacles.data()),
+            static_cast<std::streamsize>(obstacleBytes));
+    in.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+    if (!in) {
+        error = "archivo cortado";
+        return false;
+    }
+
+    std::uint64_t sum = checksum(&h, sizeof(h), kChecksumSeed);
+    sum = checksum(particles.data(), particleBytes, sum);
+    sum = checksum(obstacles.data(), obstacleBytes, sum);
+    if (sum != stored) {
+        error = "suma de verificación incorrecta";
+        return false;
+    }
+
+    sim.box = Box(h.width, h.height);
+    sim.dt = h.dt;
+    sim.totalTime = h.totalTime;
+    sim.obstacleRestitution = h.restitution;
+    sim.startStep = static_cast<int>(h.nextStep);
+
+    // En orden de inserción quedan los mismos slots que antes: las vivas
+    // al frente y las fusionadas en la cola, cada grupo en orden.
+    std::vector<Particle> restored;
+    restored.reserve(particles.size());
+    for (const CheckpointParticle& c : particles) {
+        Particle p(c.id, Vec2(c.x, c.y), Vec2(c.vx, c.vy), c.mass, c.radius);
+        p.active = c.active != 0;
+        restored.push_back(p);
+    }
+    sim.particles = ParticleStore();
+    sim.particles.assign(restored);
+
+    sim.obstacles.clear();
+    for (const CheckpointObstacle& o : obstacles) {
+        sim.addObstacle(Obstacle(Vec2(o.cx, o.cy), o.halfSize));
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+
+class Simulation;
+
+// Puntos de control binarios del estado completo de una simulación de paso
+// fijo: caja, dt, tiempo total, restitución, obstáculos, todas las
+// partículas (también las fusionadas, con su radio final) y el próximo paso
+// a ejecutar.
+//
+// Las partículas se guardan en orden de inserción y los números en binario
+// sin conversión, así que al cargar el ParticleStore queda igual slot por
+// slot y la continuación es idéntica bit a bit a la corrida original.
+//
+// Devuelven false y dejan el motivo en 'error' si algo falla.
+
+// Escribe primero en path + ".tmp" y después lo renombra: si el proceso muere
+// a mitad de camino queda el punto de control anterior.
+bool saveCheckpoint(const Simulation& sim, int nextStep,
+                    const std::string& path, std::string& error);
+
+// Reemplaza el estado de 'sim' (caja, parámetros, partículas y obstáculos) y
+// deja sim.startStep en el paso donde hay que seguir.
+bool loadCheckpoint(const std::string& path, Simulation& sim, std::string& error);
+
+#endif // CHECKPOINT_H
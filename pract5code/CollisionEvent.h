@@ -0,0 +1,28 @@
+#ifndef COLLISIONEVENT_H
+#define COLLISIONEVENT_H
+
+#include <cstdint>
+
+// Tipos de colisión que registra la simulación
+enum class CollisionKind : std::int32_t {
+    WallLeft = 0,   // MURO_IZQ
+    WallRight,      // MURO_DER
+    WallBottom,     // MURO_ABAJ
+    WallTop,        // MURO_ARR
+    Obstacle,       // COLLISION_PO, 'other' = índice del obstáculo
+    Merge           // COLLISION_PP, 'other' se fusiona en 'into'
+};
+
+// Registro de una colisión. Tiene tamaño fijo porque el formato binario lo
+// escribe tal cual.
+struct CollisionEvent {
+    double time;
+    CollisionKind kind;
+    std::int32_t particle;
+    std::int32_t other;
+    std::int32_t into;
+};
+
+static_assert(sizeof(CollisionEvent) == 24, "CollisionEvent debe medir 24 bytes");
+
+#endif // COLLISIONEVENT_H
@@ -0,0 +1,235 @@
+#include "Ensemble.h"
+#include "Simulation.h"
+#include "TaskPool.h"
+#include "PhaseProfile.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+template <typename T>
+bool readList(std::istringstream& args, std::vector<T>& out) {
+    out.clear();
+    T value;
+    while (args >> value) out.push_back(value);
+    return !out.empty() && args.eof();
+}
+
+// true si todos los valores cumplen 'ok' (y son finitos)
+template <typename Pred>
+bool allValues(const std::vector<double>& values, Pred ok) {
+    for (double v : values) {
+        if (!std::isfinite(v) || !ok(v)) return false;
+    }
+    return true;
+}
+
+std::string expandPattern(const std::string& pattern, std::size_t index) {
+    std::string out = pattern;
+    const std::string key = "{index}";
+    std::size_t at = out.find(key);
+    if (at == std::string::npos) {
+        // Sin marcador: el número va antes de la extensión
+        std::size_t dot = out.find_last_of('.');
+        std::size_t slash = out.find_last_of("/\\");
+        std::string suffix = "_" + std::to_string(index);
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return out + suffix;
+        }
+        return out.insert(dot, suffix);
+    }
+    while (at != std::string::npos) {
+        out.replace(at, key.size(), std::to_string(index));
+        at = out.find(key, at);
+    }
+    return out;
+}
+
+// Aplica los parámetros de la corrida a la copia de la simulación base
+void applyRun(const EnsembleRun& run, double jitter, Simulation& sim) {
+    sim.dt = run.dt;
+    sim.obstacleRestitution = run.restitution;
+
+    ParticleStore& s = sim.particles;
+    Random rng(run.velocitySeed);
+    s.forEachInOrder([&](std::size_t slot) {
+        s.vx[slot] *= run.velocityScale;
+        s.vy[slot] *= run.velocityScale;
+        if (jitter > 0.0) {
+            s.vx[slot] += jitter * rng.normal();
+            s.vy[slot] += jitter * rng.normal();
+        }
+    });
+}
+
+void runOne(EnsembleRun& run, double jitter, const Simulation& base) {
+    Simulation sim(base);
+    applyRun(run, jitter, sim);
+    sim.numThreads = 1;         // el paralelismo está entre corridas
+    sim.asyncOutput = false;
+    sim.verbose = false;
+    sim.checkpointEvery = 0;
+
+    PhaseProfile profile;
+    sim.profile = &profile;
+
+    auto start = std::chrono::steady_clock::now();
+    run.ok = sim.run(run.output);
+    run.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    run.alive = sim.particles.liveCount();
+    run.merges = profile.merges;
+    run.wallHits = profile.wallHits;
+    run.obstacleHits = profile.obstacleHits;
+    run.bytesWritten = profile.bytesWritten;
+}
+
+bool writeSummary(const std::string& path, const std::vector<EnsembleRun>& runs) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << std::setprecision(17);
+    out << "index,dt,restitution,velocityScale,velocitySeed,ok,seconds,alive,"
+           "merges,wallHits,obstacleHits,bytesWritten,output\n";
+    for (const EnsembleRun& r : runs) {
+        out << r.index << ',' << r.dt << ',' << r.restitution << ','
+            << r.velocityScale << ',' << r.velocitySeed << ','
+            << (r.ok ? 1 : 0) << ',' << r.seconds << ',' << r.alive << ','
+            << r.merges << ',' << r.wallHits << ',' << r.obstacleHits << ','
+            << r.bytesWritten << ',' << r.output << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+bool loadEnsembleSpec(const std::string& path, EnsembleSpec& spec,
+                      std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    std::string line;
+    std::size_t lineNo = 0;
+    auto fail = [&](const std::string& what) {
+        error = path + ":" + std::to_string(lineNo) + ": " + what;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        std::istringstream args(line);
+        std::string word;
+        if (!(args >> word)) continue;
+
+        if (word == "dt") {
+            if (!readList(args, spec.dts)) return fail("'dt' necesita valores");
+            if (!allValues(spec.dts, [](double v) { return v > 0.0; }))
+                return fail("'dt' debe ser positivo");
+        } else if (word == "restitution") {
+            if (!readList(args, spec.restitutions)) return fail("'restitution' necesita valores");
+            if (!allValues(spec.restitutions, [](double v) { return v >= 0.0 && v <= 1.0; }))
+                return fail("'restitution' debe estar entre 0 y 1");
+        } else if (word == "velocityScale") {
+            if (!readList(args, spec.velocityScales)) return fail("'velocityScale' necesita valores");
+            if (!allValues(spec.velocityScales, [](double v) { return v >= 0.0; }))
+                return fail("'velocityScale' no puede ser negativo");
+        } else if (word == "velocitySeed") {
+            if (!readList(args, spec.velocitySeeds)) return fail("'velocitySeed' necesita valores");
+        } else if (word == "velocityJitter") {
+            if (!(args >> spec.velocityJitter)) return fail("'velocityJitter' necesita un valor");
+            if (!(spec.velocityJitter >= 0.0) || !std::isfinite(spec.velocityJitter))
+                return fail("'velocityJitter' no puede ser negativo");
+        } else if (word == "output") {
+            if (!(args >> spec.outputPattern)) return fail("'output' necesita un patrón");
+        } else if (word == "summary") {
+            if (!(args >> spec.summaryFile)) return fail("'summary' necesita un archivo");
+        } else if (word == "workers") {
+            long long workers = 0;
+            if (!(args >> workers)) return fail("'workers' necesita un número");
+            if (workers < 0) return fail("'workers' no puede ser negativo");
+            spec.workers = static_cast<unsigned>(std::min<long long>(workers, UINT_MAX));
+        } else {
+            return fail("directiva desconocida: " + word);
+        }
+    }
+    return true;
+}
+
+std::vector<EnsembleRun> planEnsemble(const EnsembleSpec& spec,
+                                      const Simulation& base) {
+    std::vector<double> dts = spec.dts;
+    std::vector<double> restitutions = spec.restitutions;
+    std::vector<double> scales = spec.velocityScales;
+    std::vector<std::uint64_t> seeds = spec.velocitySeeds;
+    if (dts.empty()) dts.push_back(base.dt);
+    if (restitutions.empty()) restitutions.push_back(base.obstacleRestitution);
+    if (scales.empty()) scales.push_back(1.0);
+    if (seeds.empty()) seeds.push_back(0);
+
+    std::vector<EnsembleRun> runs;
+    runs.reserve(dts.size() * restitutions.size() * scales.size() * seeds.size());
+    double particles = static_cast<double>(base.particles.liveCount()) + 1.0;
+    for (double dt : dts) {
+        for (double e : restitutions) {
+            for (double scale : scales) {
+                for (std::uint64_t seed : seeds) {
+                    EnsembleRun run;
+                    run.index = runs.size();
+                    run.dt = dt;
+                    run.restitution = e;
+                    run.velocityScale = scale;
+                    run.velocitySeed = seed;
+                    run.output = expandPattern(spec.outputPattern, run.index);
+                    run.cost = (base.totalTime / dt + 1.0) * particles;
+                    runs.push_back(run);
+                }
+            }
+        }
+    }
+    return runs;
+}
+
+bool runEnsemble(const EnsembleSpec& spec, const Simulation& base,
+                 std::vector<EnsembleRun>& runs) {
+    runs = planEnsemble(spec, base);
+
+    unsigned workers = spec.workers;
+    if (workers == 0) workers = std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    // Más trabajadores que corridas no sirven de nada
+    if (workers > runs.size()) workers = static_cast<unsigned>(std::max<std::size_t>(1, runs.size()));
+
+    std::vector<TaskPool::Task> tasks;
+    std::vector<double> cost;
+    tasks.reserve(runs.size());
+    cost.reserve(runs.size());
+    for (EnsembleRun& run : runs) {
+        EnsembleRun* r = &run;
+        double jitter = spec.velocityJitter;
+        tasks.push_back([r, jitter, &base] { runOne(*r, jitter, base); });
+        cost.push_back(run.cost);
+    }
+
+    TaskPool pool(workers);
+    pool.run(tasks, cost);
+
+    bool allOk = writeSummary(spec.summaryFile, runs);
+    for (const EnsembleRun& run : runs) {
+        allOk = allOk && run.ok;
+    }
+    return allOk;
+}
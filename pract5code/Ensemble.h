@@ -0,0 +1,68 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+// Barrido de parámetros sobre una misma simulación base. Archivo de texto,
+// una directiva por línea ('#' inicia un comentario):
+//
+//   dt <v1> [<v2> ...]
+//   restitution <e1> [<e2> ...]
+//   velocityScale <s1> [<s2> ...]     multiplica las velocidades iniciales
+//   velocitySeed <n1> [<n2> ...]      con velocityJitter > 0
+//   velocityJitter <sigma>            suma N(0, sigma) a cada componente
+//   output <patrón>                   {index} se reemplaza por el número
+//   summary <archivo>                 resumen CSV de todas las corridas
+//   workers <n>                       corridas simultáneas (0 = núcleos)
+//
+// Se corre el producto cartesiano de todas las listas; una lista que no
+// aparece usa el valor de la simulación base.
+struct EnsembleSpec {
+    std::vector<double> dts;
+    std::vector<double> restitutions;
+    std::vector<double> velocityScales;
+    std::vector<std::uint64_t> velocitySeeds;
+    double velocityJitter = 0.0;
+    std::string outputPattern = "ensemble_{index}.txt";
+    std::string summaryFile = "ensemble_summary.csv";
+    unsigned workers = 0;
+};
+
+bool loadEnsembleSpec(const std::string& path, EnsembleSpec& spec,
+                      std::string& error);
+
+// Una corrida del barrido
+struct EnsembleRun {
+    std::size_t index = 0;
+    double dt = 0.0;
+    double restitution = 0.0;
+    double velocityScale = 1.0;
+    std::uint64_t velocitySeed = 0;
+    std::string output;
+    double cost = 0.0;          // estimación relativa: pasos * partículas
+
+    // Resultados
+    bool ok = false;
+    double seconds = 0.0;
+    std::size_t alive = 0;      // partículas activas al final
+    std::uint64_t merges = 0;
+    std::uint64_t wallHits = 0;
+    std::uint64_t obstacleHits = 0;
+    std::uint64_t bytesWritten = 0;
+};
+
+// Arma la lista de corridas del barrido a partir de la simulación base
+std::vector<EnsembleRun> planEnsemble(const EnsembleSpec& spec,
+                                      const Simulation& base);
+
+// Corre cada una sobre una copia de 'base' en un TaskPool (las más largas
+// primero), cada una con su archivo de salida, y escribe el resumen CSV.
+// Devuelve false si alguna corrida falló.
+bool runEnsemble(const EnsembleSpec& spec, const Simulation& base,
+                 std::vector<EnsembleRun>& runs);
+
+#endif // ENSEMBLE_H
@@ -0,0 +1,589 @@
+#include "EventDrivenEngine.h"
+#include "Simulation.h"
+#include "PhaseProfile.h"
+#include "TrajectoryWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+
+// Tiempo de impacto de un círculo (centro p, velocidad v, radio r) contra un
+// obstáculo cuadrado: intersección del rayo con el cuadrado "engordado" en r
+// (caras rectas y esquinas redondeadas). Solo cuenta si se está acercando.
+bool obstacleTimeOfImpact(const Vec2& p, const Vec2& v, double r,
+                          const Obstacle& o, double& outT, Vec2& outNormal) {
+    // Ya se tocan: rebota ahora si se está acercando
+    Vec2 n;
+    if (o.checkCollision(p.x, p.y, r, n)) {
+        if (v.dot(n) < 0.0) {
+            outT = 0.0;
+            outNormal = n;
+            return true;
+        }
+        return false;
+    }
+
+    double h = o.halfSize;
+    double H = h + r;
+    Vec2 rel = p - o.center;
+
+    // Rayo contra la caja [-H, H]^2 (método de las "slabs")
+    double tEnter = -std::numeric_limits<double>::infinity();
+    double tExit  =  std::numeric_limits<double>::infinity();
+    int axis = -1;
+    const double pc[2] = {rel.x, rel.y};
+    const double vc[2] = {v.x, v.y};
+    for (int k = 0; k < 2; ++k) {
+        if (vc[k] == 0.0) {
+            if (std::abs(pc[k]) > H) return false;
+            continue;
+        }
+        double t1 = (-H - pc[k]) / vc[k];
+        double t2 = ( H - pc[k]) / vc[k];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tEnter) {
+            tEnter = t1;
+            axis = k;
+        }
+        if (t2 < tExit) tExit = t2;
+    }
+    if (axis < 0 || tEnter > tExit || tExit < 0.0) return false;
+
+    double te = tEnter > 0.0 ? tEnter : 0.0;
+    Vec2 q = rel + v * te;
+
+    // Entra por una cara recta
+    if (tEnter >= 0.0 && (std::abs(q.x) <= h || std::abs(q.y) <= h)) {
+        outT = tEnter;
+        outNormal = (axis == 0) ? Vec2(v.x < 0.0 ? 1.0 : -1.0, 0.0)
+                                : Vec2(0.0, v.y < 0.0 ? 1.0 : -1.0);
+        return true;
+    }
+
+    // Zona de esquina: rayo contra el círculo de radio r en el vértice
+    Vec2 corner(q.x > 0.0 ? h : -h, q.y > 0.0 ? h : -h);
+    Vec2 d = rel - corner;
+    double a = v.dot(v);
+    double b = d.dot(v);
+    double c = d.dot(d) - r * r;
+    double disc = b * b - a * c;
+    if (b >= 0.0 || disc < 0.0) return false;
+
+    double t = c / (-b + std::sqrt(disc));
+    if (t < 0.0) return false;
+
+    outT = t;
+    outNormal = (d + v * t).normalized();
+    return true;
+}
+
+} // namespace
+
+namespace {
+
+const std::size_t kNone = static_cast<std::size_t>(-1);
+
+// Celdas algo más grandes que el diámetro máximo: así una fusión que agranda
+// un poco el radio no obliga a rearmar la grilla
+const double kCellMargin = 1.25;
+
+} // namespace
+
+EventDrivenEngine::EventDrivenEngine(Simulation& s)
+    : sim(s), endTime(0.0), purgeAt(0), alive(0),
+      cellSize(1.0), invCellSize(1.0), cols(1), rows(1), maxRadius(0.0)
+{
+}
+
+Vec2 EventDrivenEngine::positionAt(std::size_t i, double t) const {
+    const ParticleStore& s = sim.particles;
+    double dtLocal = t - t0[i];
+    return Vec2(s.x[i] + s.vx[i] * dtLocal, s.y[i] + s.vy[i] * dtLocal);
+}
+
+void EventDrivenEngine::advance(std::size_t i, double t) {
+    Vec2 p = positionAt(i, t);
+    sim.particles.x[i] = p.x;
+    sim.particles.y[i] = p.y;
+    t0[i] = t;
+}
+
+void EventDrivenEngine::syncAll(double t) {
+    ParticleStore& s = sim.particles;
+    for (std::size_t i = 0; i < s.liveCount(); ++i) {
+        if (s.active[i]) advance(i, t);
+    }
+}
+
+void EventDrivenEngine::run(TrajectoryWriter& log) {
+    ParticleStore& s = sim.particles;
+
+    int steps = static_cast<int>(sim.totalTime / sim.dt);
+    endTime = (steps + 1) * sim.dt;
+
+    t0.assign(s.size(), 0.0);
+    count.assign(s.size(), 0);
+    pending.clear();
+
+    if (sim.useObstacleIndex) {
+        obstacleIndex.build(sim.obstacles, sim.box.width, sim.box.height);
+    }
+
+    // Sin compactar durante la corrida: los slots no se mueven y las
+    // fusionadas solo quedan marcadas como inactivas
+    {
+        PhaseTimer timer(sim.profile, Phase::Pairs);
+        buildGrid(0.0);
+    }
+
+    for (int step = 0; step <= steps; ++step) {
+        double snapshot = (step + 1) * sim.dt;
+
+        while (!queue.empty() && queue.front().time <= snapshot) {
+            std::pop_heap(queue.begin(), queue.end(), std::greater<Event>());
+            Event e = queue.back();
+            queue.pop_back();
+            if (isValid(e)) handle(e);
+            if (queue.size() > purgeAt) purgeQueue();
+        }
+
+        if (sim.profile) {
+            sim.profile->steps++;
+            sim.profile->particleSteps += alive;
+        }
+        {
+            PhaseTimer timer(sim.profile, Phase::Integrate);
+            syncAll(snapshot);
+        }
+        {
+            PhaseTimer timer(sim.profile, Phase::Logging);
+            sim.recordStep(log, step * sim.dt, pending);
+        }
+        pending.clear();
+    }
+
+    queue.clear();
+    s.compact();
+}
+
+void EventDrivenEngine::schedule(const Event& e) {
+    queue.push_back(e);
+    std::push_heap(queue.begin(), queue.end(), std::greater<Event>());
+}
+
+// Los eventos invalidados se quedan en la cola hasta que salen; si se
+// juntan demasiados se sacan todos de una vez
+void EventDrivenEngine::purgeQueue() {
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [this](const Event& e) { return !isValid(e); }),
+                queue.end());
+    std::make_heap(queue.begin(), queue.end(), std::greater<Event>());
+    purgeAt = std::max(purgeAt, 2 * queue.size());
+}
+
+int EventDrivenEngine::cellCoord(double v, int n) const {
+    double c = std::floor(v * invCellSize);
+    if (c < 0.0) return 0;
+    if (c >= n) return n - 1;
+    return static_cast<int>(c);
+}
+
+void EventDrivenEngine::buildGrid(double now) {
+    ParticleStore& s = sim.particles;
+    std::size_t n = s.liveCount();
+    double width = sim.box.width;
+    double height = sim.box.height;
+
+    std::size_t active = 0;
+    maxRadius = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!s.active[i]) continue;
+        maxRadius = std::max<double>(maxRadius, s.radius[i]);
+        ++active;
+    }
+    alive = active;
+
+    // Igual que SpatialGrid: lado de al menos 2*maxR y no más de unas
+    // cuatro celdas por partícula. Sin grilla (--brute-force) hay una sola
+    // celda y se predice contra todas.
+    cellSize = 2.0 * kCellMargin * maxRadius;
+    double maxCells = 4.0 * static_cast<double>(active) + 16.0;
+    if (cellSize <= 0.0 || (width / cellSize) * (height / cellSize) > maxCells) {
+        cellSize = std::sqrt(width * height / maxCells);
+    }
+    if (!sim.useSpatialGrid || !(cellSize > 0.0)) {
+        cellSize = std::max(width, height);
+    }
+    if (!(cellSize > 0.0)) cellSize = 1.0;
+    invCellSize = 1.0 / cellSize;
+    cols = std::max(1, static_cast<int>(std::ceil(width * invCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height * invCellSize)));
+    if (!sim.useSpatialGrid) cols = rows = 1;
+
+    // Hasta este radio las que se tocan siguen en celdas vecinas
+    maxRadius = (cols == 1 && rows == 1) ? std::numeric_limits<double>::infinity()
+                                         : 0.5 * cellSize;
+
+    cellHead.assign(static_cast<std::size_t>(cols) * rows, kNone);
+    cellOf.assign(s.size(), -1);
+    nextInCell.assign(s.size(), kNone);
+    prevInCell.assign(s.size(), kNone);
+
+    // Todo lo que había en la cola se vuelve a predecir
+    queue.clear();
+    purgeAt = 8 * active + 1024;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (s.active[i]) relocate(i, now);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (s.active[i]) predict(i, now, i + 1);
+    }
+}
+
+void EventDrivenEngine::insertInCell(std::size_t i, int cell) {
+    std::size_t head = cellHead[cell];
+    cellOf[i] = cell;
+    prevInCell[i] = kNone;
+    nextInCell[i] = head;
+    if (head != kNone) prevInCell[head] = i;
+    cellHead[cell] = i;
+}
+
+void EventDrivenEngine::removeFromCell(std::size_t i) {
+    int cell = cellOf[i];
+    if (cell < 0) return;
+    if (prevInCell[i] != kNone) nextInCell[prevInCell[i]] = nextInCell[i];
+    else cellHead[cell] = nextInCell[i];
+    if (nextInCell[i] != kNone) prevInCell[nextInCell[i]] = prevInCell[i];
+    cellOf[i] = -1;
+}
+
+// Pone a i en la celda de su posición en 'now'
+void EventDrivenEngine::relocate(std::size_t i, double now) {
+    Vec2 p = positionAt(i, now);
+    int cell = cellCoord(p.y, rows) * cols + cellCoord(p.x, cols);
+    if (cell == cellOf[i]) return;
+    removeFromCell(i);
+    insertInCell(i, cell);
+}
+
+void EventDrivenEngine::predict(std::size_t i, double now, std::size_t firstOther) {
+    int cx = cellOf[i] % cols;
+    int cy = cellOf[i] / cols;
+    predictWalls(i, now);
+    predictObstacles(i, now);
+    predictCellExit(i, now);
+    predictPairs(i, now, firstOther, cx - 1, cx + 1, cy - 1, cy + 1);
+}
+
+void EventDrivenEngine::predictWalls(std::size_t i, double now) {
+    const ParticleStore& s = sim.particles;
+    Vec2 p = positionAt(i, now);
+    double r = s.radius[i];
+
+    auto scheduleWall = [&](double t, CollisionKind wall) {
+        if (t < 0.0) t = 0.0;
+        if (now + t > endTime) return;
+        schedule({now + t, Kind::Wall, i, 0, count[i], 0, wall});
+    };
+
+    if (s.vx[i] < 0.0)
+        scheduleWall((r - p.x) / s.vx[i], CollisionKind::WallLeft);
+    else if (s.vx[i] > 0.0)
+        scheduleWall((sim.box.width - r - p.x) / s.vx[i], CollisionKind::WallRight);
+
+    if (s.vy[i] < 0.0)
+        scheduleWall((r - p.y) / s.vy[i], CollisionKind::WallBottom);
+    else if (s.vy[i] > 0.0)
+        scheduleWall((sim.box.height - r - p.y) / s.vy[i], CollisionKind::WallTop);
+}
+
+// Solo los obstáculos que tocan la celda (más el radio): mientras la
+// partícula no cambie de celda no puede llegar a otros. Al cambiar de celda
+// se vuelve a llamar.
+void EventDrivenEngine::predictObstacles(std::size_t i, double now) {
+    const ParticleStore& s = sim.particles;
+    if (sim.obstacles.empty()) return;
+
+    Vec2 p = positionAt(i, now);
+    Vec2 v(s.vx[i], s.vy[i]);
+
+    const std::vector<std::size_t>* candidates = nullptr;
+    if (sim.useObstacleIndex) {
+        double half = 0.5 * cellSize;
+        double cx = (cellOf[i] % cols + 0.5) * cellSize;
+        double cy = (cellOf[i] / cols + 0.5) * cellSize;
+        obstacleIndex.query(cx, cy, half + s.radius[i], nearObstacles);
+        candidates = &nearObstacles;
+    }
+    std::size_t numCandidates = candidates ? candidates->size() : sim.obstacles.size();
+
+    // El primer obstáculo en el camino basta: cualquier otro choque
+    // posterior se vuelve a predecir después de este rebote
+    double best = std::numeric_limits<double>::infinity();
+    std::size_t bestJ = 0;
+    for (std::size_t k = 0; k < numCandidates; ++k) {
+        std::size_t j = candidates ? (*candidates)[k] : k;
+        double t;
+        Vec2 normal;
+        if (obstacleTimeOfImpact(p, v, s.radius[i], sim.obstacles[j], t, normal) &&
+            t < best) {
+            best = t;
+            bestJ = j;
+        }
+    }
+    if (sim.profile) sim.profile->obstacleTests += numCandidates;
+    if (now + best <= endTime) {
+        schedule({now + best, Kind::Obstacle, i, bestJ, count[i], 0,
+                  CollisionKind::Obstacle});
+    }
+}
+
+// Próximo borde de celda que cruza la partícula. b = 0/1/2/3 para +x, -x,
+// +y, -y. Los bordes de la grilla no se cruzan (ahí están las paredes).
+void EventDrivenEngine::predictCellExit(std::size_t i, double now) {
+    const ParticleStore& s = sim.particles;
+    if (cols == 1 && rows == 1) return;
+
+    Vec2 p = positionAt(i, now);
+    int cx = cellOf[i] % cols;
+    int cy = cellOf[i] / cols;
+
+    double best = std::numeric_limits<double>::infinity();
+    std::size_t dir = 0;
+    auto consider = [&](double velocity, double border, std::size_t d) {
+        double t = (border - (d < 2 ? p.x : p.y)) / velocity;
+        if (t < 0.0) t = 0.0;
+        if (t < best) {
+            best = t;
+            dir = d;
+        }
+    };
+    if (s.vx[i] > 0.0 && cx + 1 < cols) consider(s.vx[i], (cx + 1) * cellSize, 0);
+    if (s.vx[i] < 0.0 && cx > 0)        consider(s.vx[i], cx * cellSize, 1);
+    if (s.vy[i] > 0.0 && cy + 1 < rows) consider(s.vy[i], (cy + 1) * cellSize, 2);
+    if (s.vy[i] < 0.0 && cy > 0)        consider(s.vy[i], cy * cellSize, 3);
+
+    if (now + best <= endTime) {
+        schedule({now + best, Kind::Cell, i, dir, count[i], 0, CollisionKind::Merge});
+    }
+}
+
+void EventDrivenEngine::predictPairs(std::size_t i, double now, std::size_t firstOther,
+                                     int cx0, int cx1, int cy0, int cy1) {
+    const ParticleStore& s = sim.particles;
+    Vec2 pi = positionAt(i, now);
+    Vec2 vi(s.vx[i], s.vy[i]);
+
+    cx0 = std::max(cx0, 0);
+    cy0 = std::max(cy0, 0);
+    cx1 = std::min(cx1, cols - 1);
+    cy1 = std::min(cy1, rows - 1);
+
+    std::uint64_t tests = 0;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            for (std::size_t j = cellHead[static_cast<std::size_t>(cy) * cols + cx];
+                 j != kNone; j = nextInCell[j]) {
+                if (j == i || j < firstOther) continue;
+                ++tests;
+
+                Vec2 dp = pi - positionAt(j, now);
+                Vec2 dv = vi - Vec2(s.vx[j], s.vy[j]);
+                double sigma = s.radius[i] + s.radius[j];
+                double c = dp.dot(dp) - sigma * sigma;
+
+                double t;
+                if (c <= 0.0) {
+                    t = 0.0; // ya se tocan: se fusionan ahora (igual que el paso fijo)
+                } else {
+                    double b = dp.dot(dv);
+                    if (b >= 0.0) continue; // se alejan
+                    double a = dv.dot(dv);
+                    double disc = b * b - a * c;
+                    if (disc < 0.0) continue;
+                    t = c / (-b + std::sqrt(disc));
+                }
+
+                if (now + t > endTime) continue;
+                schedule({now + t, Kind::Pair, i, j, count[i], count[j],
+                          CollisionKind::Merge});
+            }
+        }
+    }
+    if (sim.profile) sim.profile->pairTests += tests;
+}
+
+bool EventDrivenEngine::isValid(const Event& e) const {
+    const ParticleStore& s = sim.particles;
+    if (!s.active[e.a] || count[e.a] != e.countA) return false;
+    if (e.kind == Kind::Pair && (!s.active[e.b] || count[e.b] != e.countB)) return false;
+    return true;
+}
+
+// Cada evento (con las predicciones que dispara) se mide en la fase de su
+// tipo; los cambios de celda cuentan como búsqueda de pares
+void EventDrivenEngine::handle(const Event& e) {
+    switch (e.kind) {
+    case Kind::Wall: {
+        PhaseTimer timer(sim.profile, Phase::Walls);
+        bounceWall(e);
+        break;
+    }
+    case Kind::Obstacle: {
+        PhaseTimer timer(sim.profile, Phase::Obstacles);
+        bounceObstacle(e);
+        break;
+    }
+    case Kind::Pair: {
+        PhaseTimer timer(sim.profile, Phase::Pairs);
+        merge(e);
+        break;
+    }
+    case Kind::Cell: {
+        PhaseTimer timer(sim.profile, Phase::Pairs);
+        crossCell(e);
+        break;
+    }
+    }
+}
+
+void EventDrivenEngine::bounceWall(const Event& e) {
+    ParticleStore& s = sim.particles;
+    std::size_t i = e.a;
+    advance(i, e.time);
+    double r = s.radius[i];
+
+    // Corrige el error de redondeo igual que el paso fijo
+    switch (e.wall) {
+    case CollisionKind::WallLeft:
+        if (s.x[i] < r) s.x[i] = r;
+        s.vx[i] = -s.vx[i];
+        break;
+    case CollisionKind::WallRight:
+        if (s.x[i] > sim.box.width - r) s.x[i] = sim.box.width - r;
+        s.vx[i] = -s.vx[i];
+        break;
+    case CollisionKind::WallBottom:
+        if (s.y[i] < r) s.y[i] = r;
+        s.vy[i] = -s.vy[i];
+        break;
+    default:
+        if (s.y[i] > sim.box.height - r) s.y[i] = sim.box.height - r;
+        s.vy[i] = -s.vy[i];
+        break;
+    }
+
+    ++count[i];
+    if (sim.profile) sim.profile->wallHits++;
+    pending.push_back({e.time, e.wall, s.id[i], -1, -1});
+    relocate(i, e.time);
+    predict(i, e.time, 0);
+}
+
+void EventDrivenEngine::bounceObstacle(const Event& e) {
+    ParticleStore& s = sim.particles;
+    std::size_t i = e.a;
+    advance(i, e.time);
+
+    // Normal en el punto de contacto
+    Vec2 p(s.x[i], s.y[i]);
+    Vec2 v(s.vx[i], s.vy[i]);
+    double t;
+    Vec2 normal;
+    if (!obstacleTimeOfImpact(p, v, s.radius[i], sim.obstacles[e.b], t, normal)) {
+        // Por redondeo ya no lo encuentra: se vuelve a predecir
+        ++count[i];
+        predict(i, e.time, 0);
+        return;
+    }
+
+    // Descomponer velocidad en componentes normal y tangencial
+    double v_n_scalar = v.dot(normal);
+    Vec2 v_n = normal * v_n_scalar;
+    Vec2 v_t = v - v_n;
+
+    // Aplicar coeficiente de restitución a la componente normal
+    Vec2 v_new = normal * (-sim.obstacleRestitution * v_n_scalar) + v_t;
+    s.vx[i] = v_new.x;
+    s.vy[i] = v_new.y;
+
+    ++count[i];
+    if (sim.profile) sim.profile->obstacleHits++;
+    pending.push_back({e.time, CollisionKind::Obstacle, s.id[i],
+                       static_cast<std::int32_t>(e.b), -1});
+    predict(i, e.time, 0);
+}
+
+void EventDrivenEngine::merge(const Event& e) {
+    ParticleStore& s = sim.particles;
+
+    // Como en el paso fijo, sobrevive la de menor slot (orden de inserción)
+    std::size_t a = e.a < e.b ? e.a : e.b;
+    std::size_t b = e.a < e.b ? e.b : e.a;
+    advance(a, e.time);
+    advance(b, e.time);
+
+    // Colisión completamente inelástica: se fusionan
+    double M = s.mass[a] + s.mass[b];
+
+    Vec2 va(s.vx[a], s.vy[a]), vb(s.vx[b], s.vy[b]);
+    Vec2 pa(s.x[a], s.y[a]),   pb(s.x[b], s.y[b]);
+    Vec2 newVel = (va * s.mass[a] + vb * s.mass[b]) * (1.0 / M);
+    Vec2 newPos = (pa * s.mass[a] + pb * s.mass[b]) * (1.0 / M);
+
+    s.mass[a] = M;
+    s.vx[a] = newVel.x;
+    s.vy[a] = newVel.y;
+    s.x[a] = newPos.x;
+    s.y[a] = newPos.y;
+    s.radius[a] = std::sqrt(s.radius[a] * s.radius[a] + s.radius[b] * s.radius[b]);
+
+    s.kill(b);
+    removeFromCell(b);
+    --alive;
+    ++count[a];
+    ++count[b];
+    if (sim.profile) sim.profile->merges++;
+    pending.push_back({e.time, CollisionKind::Merge, s.id[a], s.id[b], s.id[a]});
+
+    // Si ya no entra en la celda hay que rearmar la grilla (y con ella
+    // todas las predicciones)
+    if (s.radius[a] > maxRadius) {
+        buildGrid(e.time);
+        return;
+    }
+
+    // La fusionada es más grande: puede estar tocando paredes, obstáculos u
+    // otras partículas, que se detectan con tiempo 0
+    relocate(a, e.time);
+    predict(a, e.time, 0);
+}
+
+// Cambio de celda: la trayectoria sigue igual, así que los eventos ya
+// predichos siguen valiendo. Solo faltan las partículas de las celdas que
+// quedan nuevas al lado y los obstáculos de la celda nueva.
+void EventDrivenEngine::crossCell(const Event& e) {
+    std::size_t i = e.a;
+    int cx = cellOf[i] % cols;
+    int cy = cellOf[i] / cols;
+    switch (e.b) {
+    case 0:  ++cx; break;
+    case 1:  --cx; break;
+    case 2:  ++cy; break;
+    default: --cy; break;
+    }
+    removeFromCell(i);
+    insertInCell(i, cy * cols + cx);
+
+    predictObstacles(i, e.time);
+    predictCellExit(i, e.time);
+    switch (e.b) {
+    case 0:  predictPairs(i, e.time, 0, cx + 1, cx + 1, cy - 1, cy + 1); break;
+    case 1:  predictPairs(i, e.time, 0, cx - 1, cx - 1, cy - 1, cy + 1); break;
+    case 2:  predictPairs(i, e.time, 0, cx - 1, cx + 1, cy + 1, cy + 1); break;
+    default: predictPairs(i, e.time, 0, cx - 1, cx + 1, cy - 1, cy - 1); break;
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef EVENTDRIVENENGINE_H
+#define EVENTDRIVENENGINE_H
+
+#include <cstddef>
+#include <vector>
+#include "CollisionEvent.h"
+#include "ObstacleIndex.h"
+#include "Vec2.h"
+
+class Simulation;
+class TrajectoryWriter;
+
+// Motor por eventos: en vez de avanzar de a dt calcula el tiempo exacto de
+// impacto (paredes, obstáculos y otras partículas), los guarda en una cola
+// de prioridad y salta de un evento al siguiente. Entre eventos las
+// partículas se mueven en línea recta, así que no hay "tunneling".
+//
+// Cada partícula guarda el instante t0 de su último cambio y su posición en
+// ese instante; solo se actualizan las que participan en un evento. La
+// salida sigue la misma convención que el paso fijo: el estado STATE con
+// rótulo k*dt es el del final del intervalo, t = (k+1)*dt. Las colisiones
+// se registran con su tiempo exacto.
+//
+// Para no predecir contra todas, la caja se parte en celdas de lado mayor
+// que el diámetro más grande: una partícula solo puede chocar con las de
+// las 9 celdas que la rodean y con los obstáculos que tocan su celda. El
+// paso de una celda a otra es un evento más, en el que se predice contra
+// las celdas que quedan nuevas al lado.
+class EventDrivenEngine {
+public:
+    explicit EventDrivenEngine(Simulation& sim);
+
+    void run(TrajectoryWriter& log);
+
+private:
+    enum class Kind { Wall, Obstacle, Pair, Cell };
+
+    struct Event {
+        double time;
+        Kind kind;
+        std::size_t a;
+        std::size_t b;          // obstáculo, segunda partícula o dirección (Cell)
+        unsigned countA;
+        unsigned countB;
+        CollisionKind wall;     // solo para Kind::Wall
+
+        // Con el mismo tiempo decide el resto, así el orden no depende de
+        // en qué orden se agregaron
+        bool operator>(const Event& o) const {
+            if (time != o.time) return time > o.time;
+            if (kind != o.kind) return kind > o.kind;
+            if (a != o.a) return a > o.a;
+            return b > o.b;
+        }
+    };
+
+    Simulation& sim;
+    double endTime;
+
+    std::vector<double> t0;          // instante de la posición guardada
+    std::vector<unsigned> count;     // cambia en cada evento: invalida los viejos
+
+    // Montículo (std::push_heap con std::greater): a diferencia de
+    // std::priority_queue se puede recorrer para sacar los eventos viejos
+    std::vector<Event> queue;
+    std::size_t purgeAt;
+
+    std::vector<CollisionEvent> pending; // colisiones desde el último STATE
+    std::size_t alive;                   // activas, para el perfil
+
+    // Grilla de celdas: cada celda es una lista doblemente enlazada de slots
+    double cellSize;
+    double invCellSize;
+    int cols;
+    int rows;
+    double maxRadius;                // radio más grande para el que alcanza la celda
+    std::vector<int> cellOf;         // -1 = fuera de la grilla (fusionada)
+    std::vector<std::size_t> cellHead;
+    std::vector<std::size_t> nextInCell;
+    std::vector<std::size_t> prevInCell;
+
+    ObstacleIndex obstacleIndex;
+    std::vector<std::size_t> nearObstacles;
+
+    Vec2 positionAt(std::size_t i, double t) const;
+    void advance(std::size_t i, double t);
+    void syncAll(double t);
+
+    void schedule(const Event& e);
+    void purgeQueue();
+
+    // Arma la grilla con las posiciones en 'now' y vuelve a predecir todo
+    void buildGrid(double now);
+    int cellCoord(double v, int n) const;
+    void insertInCell(std::size_t i, int cell);
+    void removeFromCell(std::size_t i);
+    void relocate(std::size_t i, double now);
+
+    void predict(std::size_t i, double now, std::size_t firstOther);
+    void predictWalls(std::size_t i, double now);
+    void predictObstacles(std::size_t i, double now);
+    void predictCellExit(std::size_t i, double now);
+    // Contra las partículas (de slot >= firstOther) de las celdas
+    // [cx0, cx1] x [cy0, cy1]
+    void predictPairs(std::size_t i, double now, std::size_t firstOther,
+                      int cx0, int cx1, int cy0, int cy1);
+
+    bool isValid(const Event& e) const;
+    void handle(const Event& e);
+    void bounceWall(const Event& e);
+    void bounceObstacle(const Event& e);
+    void merge(const Event& e);
+    void crossCell(const Event& e);
+};
+
+#endif // EVENTDRIVENENGINE_H
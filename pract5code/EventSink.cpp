@@ -0,0 +1,97 @@
+#include "EventSink.h"
+#include "TrajectoryWriter.h"
+#include <algorithm>
+#include <ostream>
+
+// -------------------------------------------------------------- contador
+
+void CountingEventSink::consume(double, const CollisionEvent* events, std::size_t count) {
+    ++steps;
+    for (std::size_t k = 0; k < count; ++k) {
+        ++byKind[static_cast<std::size_t>(events[k].kind)];
+    }
+}
+
+std::uint64_t CountingEventSink::total() const {
+    std::uint64_t sum = 0;
+    for (std::uint64_t c : byKind) sum += c;
+    return sum;
+}
+
+std::uint64_t CountingEventSink::wallHits() const {
+    return count(CollisionKind::WallLeft) + count(CollisionKind::WallRight) +
+           count(CollisionKind::WallBottom) + count(CollisionKind::WallTop);
+}
+
+void CountingEventSink::print(std::ostream& out) const {
+    out << "Colisiones en " << steps << " pasos: "
+        << wallHits() << " con paredes ("
+        << count(CollisionKind::WallLeft) << " izq, "
+        << count(CollisionKind::WallRight) << " der, "
+        << count(CollisionKind::WallBottom) << " abajo, "
+        << count(CollisionKind::WallTop) << " arriba), "
+        << count(CollisionKind::Obstacle) << " con obstáculos, "
+        << count(CollisionKind::Merge) << " fusiones\n";
+}
+
+// ------------------------------------------------------- buffer circular
+
+RingBufferEventSink::RingBufferEventSink(std::size_t capacity, Handler handler_,
+                                         std::size_t batchSize_)
+    : ring(capacity > 0 ? capacity : 1),
+    head(0),
+    used(0),
+    batchSize(batchSize_),
+    dropped(0),
+    handler(std::move(handler_))
+{
+    if (batchSize == 0 || batchSize > ring.size()) batchSize = ring.size();
+}
+
+void RingBufferEventSink::consume(double, const CollisionEvent* events, std::size_t count) {
+    for (std::size_t k = 0; k < count; ++k) {
+        if (used == ring.size()) {
+            // Lleno: solo pasa sin handler, se pisa la más vieja
+            head = (head + 1) % ring.size();
+            --used;
+            ++dropped;
+        }
+        ring[(head + used) % ring.size()] = events[k];
+        ++used;
+        if (handler && used >= batchSize) deliver(used);
+    }
+}
+
+void RingBufferEventSink::finish() {
+    if (handler && used > 0) deliver(used);
+}
+
+void RingBufferEventSink::deliver(std::size_t count) {
+    // Hasta dos tramos contiguos
+    std::size_t first = std::min(count, ring.size() - head);
+    handler(ring.data() + head, first);
+    if (count > first) handler(ring.data(), count - first);
+    head = (head + count) % ring.size();
+    used -= count;
+}
+
+void RingBufferEventSink::snapshot(std::vector<CollisionEvent>& out) const {
+    out.clear();
+    out.reserve(used);
+    for (std::size_t k = 0; k < used; ++k) {
+        out.push_back(ring[(head + k) % ring.size()]);
+    }
+}
+
+// ------------------------------------------------------------------ texto
+
+void TextEventSink::consume(double, const CollisionEvent* events, std::size_t count) {
+    for (std::size_t k = 0; k < count; ++k) {
+        TextTrajectoryWriter::writeEvent(out, events[k]);
+        out << "\n";
+    }
+}
+
+void TextEventSink::finish() {
+    out.flush();
+}
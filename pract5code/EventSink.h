@@ -0,0 +1,116 @@
+#ifndef EVENTSINK_H
+#define EVENTSINK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+#include "CollisionEvent.h"
+
+constexpr std::size_t kNumCollisionKinds = static_cast<std::size_t>(CollisionKind::Merge) + 1;
+
+// Destino de las colisiones de cada paso, aparte de la salida de
+// trayectorias (Simulation::eventSink). Sirve para consumir las colisiones
+// desde el programa sin parsear el log, o para no escribir nada.
+class EventSink {
+public:
+    virtual ~EventSink() {}
+
+    // Colisiones del paso que se registra en 'time' (puede no haber), en
+    // el mismo orden que en el log. El puntero vale solo durante la llamada.
+    virtual void consume(double time, const CollisionEvent* events,
+                         std::size_t count) = 0;
+
+    // Al terminar la corrida
+    virtual void finish() {}
+};
+
+// Descarta todo
+class NullEventSink : public EventSink {
+public:
+    void consume(double, const CollisionEvent*, std::size_t) override {}
+};
+
+// Cuenta colisiones por tipo
+class CountingEventSink : public EventSink {
+public:
+    std::array<std::uint64_t, kNumCollisionKinds> byKind{};
+    std::uint64_t steps = 0;
+
+    void consume(double time, const CollisionEvent* events, std::size_t count) override;
+
+    std::uint64_t total() const;
+    std::uint64_t wallHits() const;
+    std::uint64_t count(CollisionKind kind) const {
+        return byKind[static_cast<std::size_t>(kind)];
+    }
+
+    void print(std::ostream& out) const;
+};
+
+// Buffer circular de capacidad fija; no reserva memoria después de
+// construirse.
+//
+// Con 'handler', le entrega las colisiones de a lotes de batchSize (y el
+// resto en finish()); un lote que cruza el final del buffer llega en dos
+// llamadas. Sin handler guarda las últimas 'capacity' colisiones (las más
+// viejas se pisan) y snapshot() las copia en orden.
+class RingBufferEventSink : public EventSink {
+public:
+    typedef std::function<void(const CollisionEvent* events, std::size_t count)> Handler;
+
+    explicit RingBufferEventSink(std::size_t capacity, Handler handler = Handler(),
+                                 std::size_t batchSize = 0);
+
+    void consume(double time, const CollisionEvent* events, std::size_t count) override;
+    void finish() override;
+
+    std::size_t size() const { return used; }
+    std::size_t capacity() const { return ring.size(); }
+    std::uint64_t overwritten() const { return dropped; }
+
+    void snapshot(std::vector<CollisionEvent>& out) const;
+
+private:
+    std::vector<CollisionEvent> ring;
+    std::size_t head;       // posición de la más vieja
+    std::size_t used;
+    std::size_t batchSize;
+    std::uint64_t dropped;
+    Handler handler;
+
+    void deliver(std::size_t count);
+};
+
+// Reparte cada paso a varios destinos, en orden
+class FanOutEventSink : public EventSink {
+public:
+    explicit FanOutEventSink(std::vector<EventSink*> targets) : sinks(std::move(targets)) {}
+
+    void consume(double time, const CollisionEvent* events, std::size_t count) override {
+        for (EventSink* sink : sinks) sink->consume(time, events, count);
+    }
+    void finish() override {
+        for (EventSink* sink : sinks) sink->finish();
+    }
+
+private:
+    std::vector<EventSink*> sinks;
+};
+
+// Las líneas COLLISION* del log de texto, en un flujo aparte
+class TextEventSink : public EventSink {
+public:
+    explicit TextEventSink(std::ostream& stream) : out(stream) {}
+
+    void consume(double time, const CollisionEvent* events, std::size_t count) override;
+    void finish() override;
+
+private:
+    std::ostream& out;
+};
+
+#endif // EVENTSINK_H
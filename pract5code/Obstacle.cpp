@@ -12,21 +12,24 @@ Obstacle::Obstacle(const Vec2& c, double h)
 
 bool Obstacle::checkCollision(const Particle& p, Vec2& outNormal) const {
     if (!p.active) return false;
+    return checkCollision(p.position.x, p.position.y, p.radius, outNormal);
+}
 
+bool Obstacle::checkCollision(double px, double py, double r, Vec2& outNormal) const {
     double minX = center.x - halfSize;
     double maxX = center.x + halfSize;
     double minY = center.y - halfSize;
     double maxY = center.y + halfSize;
 
     // Punto más cercano del rectángulo al centro de la partícula
-    double closestX = max(minX, min(p.position.x, maxX));
-    double closestY = max(minY, min(p.position.y, maxY));
+    double closestX = max(minX, min(px, maxX));
+    double closestY = max(minY, min(py, maxY));
 
-    double dx = p.position.x - closestX;
-    double dy = p.position.y - closestY;
+    double dx = px - closestX;
+    double dy = py - closestY;
     double dist2 = dx * dx + dy * dy;
 
-    if (dist2 > p.radius * p.radius) {
+    if (dist2 > r * r) {
         return false;
     }
 
@@ -34,10 +37,10 @@ bool Obstacle::checkCollision(const Particle& p, Vec2& outNormal) const {
     // Caso especial: centro dentro del rectángulo
     if (dist2 == 0.0) {
         // Elegimos normal basándonos en la menor distancia a un lado
-        double leftDist   = abs(p.position.x - minX);
-        double rightDist  = abs(maxX - p.position.x);
-        double bottomDist = abs(p.position.y - minY);
-        double topDist    = abs(maxY - p.position.y);
+        double leftDist   = abs(px - minX);
+        double rightDist  = abs(maxX - px);
+        double bottomDist = abs(py - minY);
+        double topDist    = abs(maxY - py);
 
         double minDist = min(min(leftDist, rightDist),
                                   min(bottomDist, topDist));
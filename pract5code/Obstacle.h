@@ -2,8 +2,7 @@
 #define OBSTACLE_H
 
 #include "Vec2.h"
-
-class Particle;
+#include "Particle.h"
 
 class Obstacle {
 public:
@@ -15,6 +14,9 @@ public:
     // Detecta colisión círculo-rectángulo
     // Devuelve true si hay colisión y escribe la normal de la superficie.
     bool checkCollision(const Particle& p, Vec2& outNormal) const;
+
+    // Igual que la anterior, a partir del centro (px, py) y el radio r
+    bool checkCollision(double px, double py, double r, Vec2& outNormal) const;
 };
 
 #endif
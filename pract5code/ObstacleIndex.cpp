@@ -0,0 +1,93 @@
+#include "ObstacleIndex.h"
+#include <algorithm>
+#include <cmath>
+
+ObstacleIndex::ObstacleIndex()
+    : invCellSize(1.0), cols(1), rows(1), numObstacles(0)
+{
+}
+
+int ObstacleIndex::cellCoord(double v, int n) const {
+    double c = std::floor(v * invCellSize);
+    if (c < 0.0) return 0;
+    if (c >= n) return n - 1;
+    return static_cast<int>(c);
+}
+
+void ObstacleIndex::build(const std::vector<Obstacle>& obstacles,
+                          double width, double height) {
+    numObstacles = obstacles.size();
+
+    // Celdas del tamaño del obstáculo más grande, pero no más celdas que
+    // unas cuatro por obstáculo
+    double maxHalf = 0.0;
+    for (const Obstacle& o : obstacles) {
+        maxHalf = std::max(maxHalf, o.halfSize);
+    }
+    double cellSize = 2.0 * maxHalf;
+    double minCell = std::sqrt(width * height / (4.0 * numObstacles + 1.0));
+    if (cellSize < minCell) cellSize = minCell;
+    if (cellSize <= 0.0) cellSize = std::max(width, height);
+    if (cellSize <= 0.0) cellSize = 1.0;
+
+    invCellSize = 1.0 / cellSize;
+    cols = std::max(1, static_cast<int>(std::ceil(width * invCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height * invCellSize)));
+
+    // Obstáculos fuera de la caja quedan en las celdas del borde: como las
+    // consultas también se recortan al borde, igual se encuentran.
+    std::size_t numCells = static_cast<std::size_t>(cols) * rows;
+    cellStart.assign(numCells + 1, 0);
+
+    auto forEachCell = [&](const Obstacle& o, auto&& f) {
+        int cx0 = cellCoord(o.center.x - o.halfSize, cols);
+        int cx1 = cellCoord(o.center.x + o.halfSize, cols);
+        int cy0 = cellCoord(o.center.y - o.halfSize, rows);
+        int cy1 = cellCoord(o.center.y + o.halfSize, rows);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                f(static_cast<std::size_t>(cy) * cols + cx);
+    };
+
+    for (const Obstacle& o : obstacles) {
+        forEachCell(o, [&](std::size_t c) { ++cellStart[c + 1]; });
+    }
+    for (std::size_t c = 0; c < numCells; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    entries.resize(cellStart[numCells]);
+    std::vector<std::size_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t j = 0; j < obstacles.size(); ++j) {
+        forEachCell(obstacles[j], [&](std::size_t c) { entries[fill[c]++] = j; });
+    }
+}
+
+void ObstacleIndex::query(double px, double py, double r,
+                          std::vector<std::size_t>& out) const {
+    out.clear();
+    if (numObstacles == 0) return;
+
+    // Un poco de margen: checkCollision compara distancias al cuadrado y
+    // el redondeo puede aceptar un contacto a una fracción de ulp del borde
+    double reach = r + 1e-9 * (r + std::abs(px) + std::abs(py));
+
+    int cx0 = cellCoord(px - reach, cols);
+    int cx1 = cellCoord(px + reach, cols);
+    int cy0 = cellCoord(py - reach, rows);
+    int cy1 = cellCoord(py + reach, rows);
+
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            std::size_t c = static_cast<std::size_t>(cy) * cols + cx;
+            out.insert(out.end(), entries.begin() + cellStart[c],
+                       entries.begin() + cellStart[c + 1]);
+        }
+    }
+
+    // Un obstáculo grande puede estar en varias celdas
+    if (cx0 != cx1 || cy0 != cy1) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
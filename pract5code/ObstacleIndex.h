@@ -0,0 +1,38 @@
+#ifndef OBSTACLEINDEX_H
+#define OBSTACLEINDEX_H
+
+#include <vector>
+#include <cstddef>
+#include "Obstacle.h"
+
+// Índice estático de obstáculos: una grilla sobre la caja donde cada celda
+// tiene la lista de obstáculos que la tocan. Los obstáculos no se mueven,
+// así que se arma una sola vez al empezar la corrida.
+class ObstacleIndex {
+public:
+    ObstacleIndex();
+
+    void build(const std::vector<Obstacle>& obstacles,
+               double width, double height);
+
+    // Cantidad de obstáculos con la que se armó (para saber si está al día)
+    std::size_t builtFor() const { return numObstacles; }
+
+    // Deja en 'out' los índices de los obstáculos cerca de un círculo de
+    // centro (px, py) y radio r, sin repetir y en orden creciente
+    void query(double px, double py, double r, std::vector<std::size_t>& out) const;
+
+private:
+    double invCellSize;
+    int cols;
+    int rows;
+    std::size_t numObstacles;
+
+    // Lista de obstáculos de la celda c: entries[cellStart[c] .. cellStart[c+1])
+    std::vector<std::size_t> cellStart;
+    std::vector<std::size_t> entries;
+
+    int cellCoord(double v, int n) const;
+};
+
+#endif // OBSTACLEINDEX_H
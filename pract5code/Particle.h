@@ -3,19 +3,30 @@
 
 #include "Vec2.h"
 
-class Particle {
+// Partícula suelta (entrada de escenarios, ParticleStore::get). El estado de
+// la simulación vive en ParticleStore, en columnas de tipo Scalar.
+template <typename T>
+class ParticleT {
 public:
     int id;
-    Vec2 position;
-    Vec2 velocity;
-    double mass;
-    double radius;
+    Vec2T<T> position;
+    Vec2T<T> velocity;
+    T mass;
+    T radius;
     bool active;
 
-    Particle(int id_, const Vec2& pos, const Vec2& vel,
-             double m, double r);
+    constexpr ParticleT(int id_, const Vec2T<T>& pos, const Vec2T<T>& vel,
+                        T m, T r)
+        : id(id_), position(pos), velocity(vel),
+        mass(m), radius(r), active(true)
+    {
+    }
 
-    void update(double dt);
+    constexpr void update(T dt) {
+        position += velocity * dt;
+    }
 };
 
+typedef ParticleT<double> Particle;
+
 #endif // PARTICLE_H
@@ -0,0 +1,245 @@
+#include "ParticleStore.h"
+#include <algorithm>
+
+template <typename T>
+ParticleStoreT<T>::ParticleStoreT()
+    : live(0), pendingKills(0), ordered(true)
+{
+}
+
+template <typename T>
+void ParticleStoreT<T>::reserve(std::size_t n) {
+    id.reserve(n);
+    x.reserve(n);
+    y.reserve(n);
+    vx.reserve(n);
+    vy.reserve(n);
+    mass.reserve(n);
+    radius.reserve(n);
+    active.reserve(n);
+    handle.reserve(n);
+    slotOf.reserve(n);
+    handleOfId.reserve(n);
+}
+
+template <typename T>
+void ParticleStoreT<T>::add(const Particle& p) {
+    std::size_t h = slotOf.size();
+
+    id.push_back(p.id);
+    x.push_back(static_cast<T>(p.position.x));
+    y.push_back(static_cast<T>(p.position.y));
+    vx.push_back(static_cast<T>(p.velocity.x));
+    vy.push_back(static_cast<T>(p.velocity.y));
+    mass.push_back(static_cast<T>(p.mass));
+    radius.push_back(static_cast<T>(p.radius));
+    active.push_back(p.active ? 1 : 0);
+    handle.push_back(h);
+    slotOf.push_back(size() - 1);
+    handleOfId[p.id] = h;
+
+    // Una partícula viva nueva va al final del rango vivo: rotamos la cola
+    // de inactivas un lugar para hacerle espacio sin desordenarla.
+    if (p.active) {
+        if (live < size() - 1) {
+            rotateTail(live);
+        }
+        ++live;
+    }
+}
+
+template <typename T>
+void ParticleStoreT<T>::assign(const std::vector<Particle>& inOrder) {
+    std::size_t n = inOrder.size();
+    std::size_t liveCount = 0;
+    for (const Particle& p : inOrder) {
+        if (p.active) ++liveCount;
+    }
+
+    id.resize(n);
+    x.resize(n);
+    y.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    mass.resize(n);
+    radius.resize(n);
+    active.resize(n);
+    handle.resize(n);
+    slotOf.resize(n);
+    handleOfId.clear();
+    handleOfId.reserve(n);
+
+    std::size_t nextLive = 0;
+    std::size_t nextDead = liveCount;
+    for (std::size_t h = 0; h < n; ++h) {
+        const Particle& p = inOrder[h];
+        std::size_t s = p.active ? nextLive++ : nextDead++;
+        id[s] = p.id;
+        x[s] = static_cast<T>(p.position.x);
+        y[s] = static_cast<T>(p.position.y);
+        vx[s] = static_cast<T>(p.velocity.x);
+        vy[s] = static_cast<T>(p.velocity.y);
+        mass[s] = static_cast<T>(p.mass);
+        radius[s] = static_cast<T>(p.radius);
+        active[s] = p.active ? 1 : 0;
+        handle[s] = h;
+        slotOf[h] = s;
+        handleOfId[p.id] = h;
+    }
+
+    live = liveCount;
+    pendingKills = 0;
+    ordered = true;
+}
+
+template <typename T>
+void ParticleStoreT<T>::rotateTail(std::size_t from) {
+    auto rot = [from](auto& v) {
+        std::rotate(v.begin() + from, v.end() - 1, v.end());
+    };
+    rot(id);
+    rot(x);
+    rot(y);
+    rot(vx);
+    rot(vy);
+    rot(mass);
+    rot(radius);
+    rot(active);
+    rot(handle);
+    for (std::size_t s = from; s < size(); ++s) {
+        slotOf[handle[s]] = s;
+    }
+}
+
+template <typename T>
+Particle ParticleStoreT<T>::get(std::size_t slot) const {
+    Particle p(id[slot], Vec2(x[slot], y[slot]), Vec2(vx[slot], vy[slot]),
+               mass[slot], radius[slot]);
+    p.active = active[slot] != 0;
+    return p;
+}
+
+template <typename T>
+void ParticleStoreT<T>::kill(std::size_t slot) {
+    if (!active[slot]) return;
+    active[slot] = 0;
+    ++pendingKills;
+}
+
+template <typename T>
+template <typename C>
+void ParticleStoreT<T>::permute(std::vector<C>& column) {
+    std::vector<C> tmp(column.size());
+    for (std::size_t s = 0; s < order.size(); ++s) {
+        tmp[s] = column[order[s]];
+    }
+    column.swap(tmp);
+}
+
+template <typename T>
+template <typename C>
+void ParticleStoreT<T>::compactColumn(std::vector<C>& column, std::vector<C>& saved,
+                                      std::size_t first) {
+    saved.clear();
+    for (std::size_t s : newlyDead) saved.push_back(column[s]);
+
+    // order[k] >= size() es la recién muerta order[k] - size(). Los demás
+    // orígenes nunca están antes del destino, así que se copia en el lugar.
+    std::size_t dead = size();
+    for (std::size_t k = 0; k < order.size(); ++k) {
+        std::size_t from = order[k];
+        column[first + k] = from >= dead ? saved[from - dead] : column[from];
+    }
+}
+
+template <typename T>
+void ParticleStoreT<T>::compact() {
+    if (pendingKills == 0) return;
+
+    // Lo que está antes de la primera muerta no se mueve
+    std::size_t first = 0;
+    while (first < live && active[first]) ++first;
+
+    // Nuevo orden desde 'first': las vivas (en su orden) y después la cola
+    // de inactivas con las recién muertas intercaladas por handle. Pasada
+    // la última recién muerta la cola ya está en su lugar.
+    order.clear();
+    newlyDead.clear();
+    for (std::size_t s = first; s < live; ++s) {
+        if (active[s]) order.push_back(s);
+        else           newlyDead.push_back(s);
+    }
+    std::size_t newLive = first + order.size();
+    if (!ordered) {
+        std::sort(newlyDead.begin(), newlyDead.end(),
+                  [this](std::size_t a, std::size_t b) { return handle[a] < handle[b]; });
+    }
+
+    std::size_t dead = size();
+    std::size_t a = 0;
+    std::size_t b = live;
+    while (a < newlyDead.size()) {
+        if (b < size() && handle[b] < handle[newlyDead[a]]) {
+            order.push_back(b++);
+        } else {
+            order.push_back(dead + a++);
+        }
+    }
+
+    compactColumn(id, savedId, first);
+    compactColumn(x, savedValue, first);
+    compactColumn(y, savedValue, first);
+    compactColumn(vx, savedValue, first);
+    compactColumn(vy, savedValue, first);
+    compactColumn(mass, savedValue, first);
+    compactColumn(radius, savedValue, first);
+    compactColumn(active, savedActive, first);
+    compactColumn(handle, savedHandle, first);
+    for (std::size_t s = first; s < first + order.size(); ++s) {
+        slotOf[handle[s]] = s;
+    }
+
+    live = newLive;
+    pendingKills = 0;
+}
+
+template <typename T>
+void ParticleStoreT<T>::reorderLive(const std::vector<std::size_t>& newOrder) {
+    order.assign(newOrder.begin(), newOrder.end());
+    for (std::size_t s = live; s < size(); ++s) {
+        order.push_back(s);
+    }
+    applyOrder();
+
+    ordered = true;
+    for (std::size_t s = 1; s < live && ordered; ++s) {
+        ordered = handle[s - 1] < handle[s];
+    }
+}
+
+template <typename T>
+void ParticleStoreT<T>::applyOrder() {
+    permute(id);
+    permute(x);
+    permute(y);
+    permute(vx);
+    permute(vy);
+    permute(mass);
+    permute(radius);
+    permute(active);
+    permute(handle);
+    for (std::size_t s = 0; s < size(); ++s) {
+        slotOf[handle[s]] = s;
+    }
+}
+
+template <typename T>
+bool ParticleStoreT<T>::findId(int particleId, std::size_t& slot) const {
+    auto it = handleOfId.find(particleId);
+    if (it == handleOfId.end()) return false;
+    slot = slotOf[it->second];
+    return true;
+}
+
+template class ParticleStoreT<float>;
+template class ParticleStoreT<double>;
@@ -0,0 +1,122 @@
+#ifndef PARTICLESTORE_H
+#define PARTICLESTORE_H
+
+#include <vector>
+#include <cstddef>
+#include <unordered_map>
+#include "Particle.h"
+#include "Scalar.h"
+
+// Almacenamiento "structure of arrays" de las partículas, con las columnas
+// de punto flotante en T (ParticleStore usa Scalar, ver Scalar.h).
+//
+// Los slots [0, liveCount()) tienen las partículas activas y los slots
+// [liveCount(), size()) las fusionadas (inactivas), que ya no cambian.
+// La cola de fusionadas siempre está ordenada por orden de inserción
+// ("handle"). El rango vivo también, salvo después de reorderLive(); por
+// eso el log y las fusiones se ordenan por handle y no por slot.
+template <typename T>
+class ParticleStoreT {
+public:
+    typedef T value_type;
+
+    std::vector<int> id;
+    std::vector<T> x;
+    std::vector<T> y;
+    std::vector<T> vx;
+    std::vector<T> vy;
+    std::vector<T> mass;
+    std::vector<T> radius;
+    std::vector<unsigned char> active;
+    std::vector<std::size_t> handle; // slot -> orden de inserción
+
+    ParticleStoreT();
+
+    std::size_t size() const { return id.size(); }
+    std::size_t liveCount() const { return live; }
+
+    void reserve(std::size_t n);
+    // La entrada está en double; se redondea a T al guardarla
+    void add(const Particle& p);
+
+    // Reemplaza todo el contenido por 'inOrder' (en orden de inserción).
+    // Queda igual que llamando add() con cada una, pero en O(n): las vivas
+    // van directo al frente y las inactivas a la cola.
+    void assign(const std::vector<Particle>& inOrder);
+
+    // Copia de la partícula en el slot indicado
+    Particle get(std::size_t slot) const;
+
+    // Marca la partícula como inactiva. Sigue en el rango vivo hasta el
+    // próximo compact(), así los índices no se mueven durante una fase.
+    void kill(std::size_t slot);
+
+    // Saca del rango vivo las partículas marcadas con kill()
+    void compact();
+
+    // Reubica el rango vivo: el nuevo slot k tiene lo que estaba en
+    // newOrder[k] (una permutación de [0, liveCount())). Los ids y los
+    // handles no cambian.
+    void reorderLive(const std::vector<std::size_t>& newOrder);
+
+    // true si el rango vivo está ordenado por handle (slot creciente =
+    // orden de inserción)
+    bool inHandleOrder() const { return ordered; }
+
+    std::size_t slotOfHandle(std::size_t h) const { return slotOf[h]; }
+
+    // Busca el slot actual de una partícula por su id
+    bool findId(int particleId, std::size_t& slot) const;
+
+    // Recorre todos los slots en orden de inserción (mezcla el rango vivo
+    // con la cola de fusionadas, que están ordenados cada uno)
+    template <typename F>
+    void forEachInOrder(F&& f) const {
+        if (!ordered) {
+            for (std::size_t h = 0; h < slotOf.size(); ++h) f(slotOf[h]);
+            return;
+        }
+        std::size_t n = size();
+        std::size_t a = 0;
+        std::size_t b = live;
+        while (a < live || b < n) {
+            if (b >= n || (a < live && handle[a] < handle[b])) f(a++);
+            else                                               f(b++);
+        }
+    }
+
+private:
+    std::size_t live;
+    std::size_t pendingKills;
+    bool ordered;
+    std::vector<std::size_t> slotOf; // handle -> slot
+    std::unordered_map<int, std::size_t> handleOfId;
+
+    std::vector<std::size_t> order; // temporal para compact() y reorderLive()
+
+    // Auxiliares de compact(), se reutilizan: las recién muertas y una
+    // copia de sus valores en cada columna
+    std::vector<std::size_t> newlyDead;
+    std::vector<int> savedId;
+    std::vector<T> savedValue;
+    std::vector<unsigned char> savedActive;
+    std::vector<std::size_t> savedHandle;
+
+    void rotateTail(std::size_t from);
+    template <typename C>
+    void permute(std::vector<C>& column);
+    // Aplica 'order' (posición - first -> slot viejo) a una columna desde
+    // 'first', con las recién muertas guardadas en 'saved'
+    template <typename C>
+    void compactColumn(std::vector<C>& column, std::vector<C>& saved, std::size_t first);
+    // Aplica 'order' (slot nuevo -> slot viejo) a todas las columnas
+    void applyOrder();
+};
+
+// Instanciadas en ParticleStore.cpp
+extern template class ParticleStoreT<float>;
+extern template class ParticleStoreT<double>;
+
+typedef ParticleStoreT<Scalar> ParticleStore;
+
+#endif // PARTICLESTORE_H
@@ -0,0 +1,89 @@
+#include "PhaseProfile.h"
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+const char* phaseName(Phase phase) {
+    switch (phase) {
+    case Phase::Reorder:   return "reorder";
+    case Phase::Integrate: return "integrate";
+    case Phase::Walls:     return "walls";
+    case Phase::Obstacles: return "obstacles";
+    case Phase::Pairs:     return "pairs";
+    case Phase::Logging:   return "logging";
+    default:               return "?";
+    }
+}
+
+void PhaseProfile::reset() {
+    ns.fill(0);
+    allocations.fill(0);
+    steps = 0;
+    particleSteps = 0;
+    pairTests = 0;
+    merges = 0;
+    obstacleTests = 0;
+    obstacleHits = 0;
+    wallHits = 0;
+    reorders = 0;
+    bytesWritten = 0;
+}
+
+std::uint64_t PhaseProfile::totalNs() const {
+    std::uint64_t total = 0;
+    for (std::uint64_t t : ns) total += t;
+    return total;
+}
+
+void PhaseProfile::printSummary(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    double total = static_cast<double>(totalNs());
+
+    out << "Perfil: " << steps << " pasos, " << particleSteps
+        << " partículas-paso\n";
+    out << std::fixed;
+    for (std::size_t k = 0; k < kNumPhases; ++k) {
+        double ms = ns[k] / 1e6;
+        double share = total > 0.0 ? 100.0 * ns[k] / total : 0.0;
+        double perParticle = particleSteps ? double(ns[k]) / particleSteps : 0.0;
+        out << "  " << std::left << std::setw(10) << phaseName(static_cast<Phase>(k))
+            << std::right << std::setprecision(2) << std::setw(11) << ms << " ms"
+            << std::setprecision(1) << std::setw(7) << share << " %"
+            << std::setprecision(2) << std::setw(10) << perParticle << " ns/part\n";
+    }
+    out << "  pares:      " << pairTests << " pruebas, " << merges << " fusiones\n";
+    out << "  obstáculos: " << obstacleTests << " pruebas, " << obstacleHits << " choques\n";
+    out << "  paredes:    " << wallHits << " choques\n";
+    out << "  memoria:    " << reorders << " reordenamientos\n";
+    out << "  salida:     " << bytesWritten << " bytes\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool PhaseProfile::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "{\n";
+    out << "  \"steps\": " << steps << ",\n";
+    out << "  \"particleSteps\": " << particleSteps << ",\n";
+    out << "  \"phases\": {\n";
+    for (std::size_t k = 0; k < kNumPhases; ++k) {
+        out << "    \"" << phaseName(static_cast<Phase>(k)) << "\": {\"ns\": " << ns[k];
+        if (allocationCounter) out << ", \"allocations\": " << allocations[k];
+        out << "}" << (k + 1 < kNumPhases ? "," : "") << "\n";
+    }
+    out << "  },\n";
+    out << "  \"totalNs\": " << totalNs() << ",\n";
+    out << "  \"pairTests\": " << pairTests << ",\n";
+    out << "  \"merges\": " << merges << ",\n";
+    out << "  \"obstacleTests\": " << obstacleTests << ",\n";
+    out << "  \"obstacleHits\": " << obstacleHits << ",\n";
+    out << "  \"wallHits\": " << wallHits << ",\n";
+    out << "  \"reorders\": " << reorders << ",\n";
+    out << "  \"bytesWritten\": " << bytesWritten << "\n";
+    out << "}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,89 @@
+#ifndef PHASEPROFILE_H
+#define PHASEPROFILE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Fases de un paso de tiempo fijo, en el orden en que se ejecutan. El motor
+// por eventos mide cada evento en la fase de su tipo (los cambios de celda y
+// el armado de la grilla van en Pairs), el avance hasta cada STATE en
+// Integrate y la salida en Logging.
+enum class Phase {
+    Reorder,
+    Integrate,
+    Walls,
+    Obstacles,
+    Pairs,
+    Logging,
+    Count
+};
+
+constexpr std::size_t kNumPhases = static_cast<std::size_t>(Phase::Count);
+
+const char* phaseName(Phase phase);
+
+// Tiempos acumulados por fase y contadores de trabajo. Simulation los llena
+// solo si Simulation::profile apunta a uno; con nullptr no se mide nada.
+struct PhaseProfile {
+    std::array<std::uint64_t, kNumPhases> ns{};
+    std::array<std::uint64_t, kNumPhases> allocations{};
+    std::uint64_t steps = 0;
+    std::uint64_t particleSteps = 0;    // suma de partículas vivas por paso
+
+    std::uint64_t pairTests = 0;        // distancias calculadas entre pares
+    std::uint64_t merges = 0;
+    std::uint64_t obstacleTests = 0;    // pruebas círculo-rectángulo
+    std::uint64_t obstacleHits = 0;
+    std::uint64_t wallHits = 0;
+    std::uint64_t reorders = 0;         // reordenamientos Morton hechos
+    std::uint64_t bytesWritten = 0;     // tamaño final de la salida
+
+    // Opcional: devuelve cuántas reservas de memoria van hasta ahora. Lo
+    // pone quien mide (el benchmark cuenta las llamadas a operator new).
+    std::uint64_t (*allocationCounter)() = nullptr;
+
+    void reset();
+    std::uint64_t totalNs() const;
+
+    // Resumen legible para el final de la corrida
+    void printSummary(std::ostream& out) const;
+    // Lo mismo en JSON (archivo aparte junto a la salida)
+    bool writeJson(const std::string& path) const;
+};
+
+// Mide una fase mientras está viva. Con profile == nullptr no hace nada.
+class PhaseTimer {
+public:
+    PhaseTimer(PhaseProfile* profile, Phase phase)
+        : profile(profile), phase(static_cast<std::size_t>(phase))
+    {
+        if (!profile) return;
+        allocStart = profile->allocationCounter ? profile->allocationCounter() : 0;
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer() {
+        if (!profile) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        profile->ns[phase] += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        if (profile->allocationCounter) {
+            profile->allocations[phase] += profile->allocationCounter() - allocStart;
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    PhaseProfile* profile;
+    std::size_t phase;
+    std::uint64_t allocStart = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // PHASEPROFILE_H
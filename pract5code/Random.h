@@ -0,0 +1,45 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+// Números al azar sin depender de las distribuciones de la biblioteca
+// estándar (cambian entre compiladores): misma semilla, mismos números.
+// Lo usan el generador de escenarios y el ensamble.
+class Random {
+public:
+    explicit Random(std::uint64_t seed) : engine(seed) {}
+
+    double uniform() { // [0, 1)
+        return static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double uniform(double a, double b) {
+        return a + (b - a) * uniform();
+    }
+
+    double normal() { // Box-Muller
+        if (hasSpare) {
+            hasSpare = false;
+            return spare;
+        }
+        double u1 = uniform();
+        double u2 = uniform();
+        if (u1 < 1e-300) u1 = 1e-300;
+        double mag = std::sqrt(-2.0 * std::log(u1));
+        spare = mag * std::sin(kTwoPi * u2);
+        hasSpare = true;
+        return mag * std::cos(kTwoPi * u2);
+    }
+
+private:
+    static constexpr double kTwoPi = 2.0 * 3.14159265358979323846;
+
+    std::mt19937_64 engine;
+    bool hasSpare = false;
+    double spare = 0.0;
+};
+
+#endif // RANDOM_H
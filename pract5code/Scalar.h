@@ -0,0 +1,18 @@
+#ifndef SCALAR_H
+#define SCALAR_H
+
+// Tipo de punto flotante del estado de la simulación (columnas de
+// ParticleStore y kernels). Por defecto double. Compilando con P5_FLOAT
+// (qmake: CONFIG += p5_float) pasa a float: la mitad de memoria y de ancho
+// de banda con muchas partículas, a cambio de precisión. Para ver si
+// alcanza, comparar las trayectorias con compare/ (p5compare).
+//
+// La entrada (escenarios, Particle), los obstáculos y los archivos de
+// salida siguen en double.
+#ifdef P5_FLOAT
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
+#endif // SCALAR_H
@@ -0,0 +1,361 @@
+#include "Scenario.h"
+#include "Simulation.h"
+#include "ObstacleIndex.h"
+#include "Random.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Tope para 'particles' (es solo una reserva de memoria)
+const double kMaxParticles = 1e8;
+
+// ----------------------------------------------------------- generador
+
+// Grilla con listas enlazadas para ver si un círculo nuevo toca a alguno
+// ya ubicado. Con celdas de lado >= 2*rmax alcanza con las 9 vecinas.
+class PlacementGrid {
+public:
+    PlacementGrid(double width, double height, double cell, std::size_t expected)
+        : inv(1.0 / limitCell(width, height, cell, expected)),
+        cols(std::max(1L, static_cast<long>(std::ceil(width * inv)))),
+        rows(std::max(1L, static_cast<long>(std::ceil(height * inv))))
+    {
+        head.assign(static_cast<std::size_t>(cols) * rows, -1);
+        x.reserve(expected);
+        y.reserve(expected);
+        r.reserve(expected);
+        next.reserve(expected);
+    }
+
+    bool overlaps(double px, double py, double pr) const {
+        long cx = coord(px, cols);
+        long cy = coord(py, rows);
+        for (long j = std::max(0L, cy - 1); j <= std::min(rows - 1, cy + 1); ++j) {
+            for (long i = std::max(0L, cx - 1); i <= std::min(cols - 1, cx + 1); ++i) {
+                for (long k = head[j * cols + i]; k >= 0; k = next[k]) {
+                    double dx = px - x[k];
+                    double dy = py - y[k];
+                    double d = pr + r[k];
+                    if (dx * dx + dy * dy <= d * d) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void insert(double px, double py, double pr) {
+        long c = coord(py, rows) * cols + coord(px, cols);
+        x.push_back(px);
+        y.push_back(py);
+        r.push_back(pr);
+        next.push_back(head[c]);
+        head[c] = static_cast<long>(x.size()) - 1;
+    }
+
+private:
+    double inv;
+    long cols;
+    long rows;
+    std::vector<long> head;
+    std::vector<long> next;
+    std::vector<double> x, y, r;
+
+    // Como en SpatialGrid::build: una caja enorme con radios chicos no debe
+    // comerse la memoria. Celdas más grandes siguen alcanzando con 9 vecinas.
+    static double limitCell(double width, double height, double cell,
+                            std::size_t expected) {
+        double maxCells = 4.0 * static_cast<double>(expected) + 16.0;
+        if ((width / cell) * (height / cell) > maxCells) {
+            cell = std::sqrt(width * height / maxCells);
+        }
+        return cell;
+    }
+
+    long coord(double v, long n) const {
+        long c = static_cast<long>(std::floor(v * inv));
+        return std::min(n - 1, std::max(0L, c));
+    }
+};
+
+// ------------------------------------------------------------- parser
+
+// Lee números de una línea avanzando un puntero, sin crear strings
+bool readNumber(const char*& p, double& out) {
+    char* end;
+    out = std::strtod(p, &end);
+    if (end == p) return false;
+    p = end;
+    return true;
+}
+
+// "min:max" con min <= max
+bool readRange(const char* text, double& a, double& b) {
+    char* end;
+    a = std::strtod(text, &end);
+    if (end == text || *end != ':') return false;
+    const char* second = end + 1;
+    b = std::strtod(second, &end);
+    return end != second && *end == '\0' && std::isfinite(a) && std::isfinite(b) && a <= b;
+}
+
+// Número solo, sin nada detrás
+bool readValue(const char* text, double& out) {
+    char* end;
+    out = std::strtod(text, &end);
+    return end != text && *end == '\0' && std::isfinite(out);
+}
+
+// Entero sin signo (strtoull acepta "-1" y lo da vuelta)
+bool readUnsigned(const char* text, std::uint64_t& out) {
+    if (*text < '0' || *text > '9') return false;
+    char* end;
+    errno = 0;
+    unsigned long long v = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE) return false;
+    out = v;
+    return true;
+}
+
+bool parseGenerate(const char* p, GeneratorConfig& cfg, std::string& error) {
+    bool hasCount = false;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') ++p;
+        if (!*p) break;
+
+        const char* keyEnd = std::strchr(p, '=');
+        if (!keyEnd) {
+            error = "se esperaba clave=valor en 'generate'";
+            return false;
+        }
+        std::string key(p, keyEnd);
+        const char* value = keyEnd + 1;
+        const char* valueEnd = value;
+        while (*valueEnd && *valueEnd != ' ' && *valueEnd != '\t') ++valueEnd;
+        std::string text(value, valueEnd);
+        p = valueEnd;
+
+        bool ok = true;
+        if (key == "count") {
+            std::uint64_t n = 0;
+            ok = readUnsigned(text.c_str(), n) && n > 0 && n <= kMaxParticles;
+            cfg.count = static_cast<std::size_t>(n);
+            hasCount = true;
+        } else if (key == "seed") {
+            ok = readUnsigned(text.c_str(), cfg.seed);
+        } else if (key == "radius") {
+            ok = readRange(text.c_str(), cfg.minRadius, cfg.maxRadius) &&
+                 cfg.minRadius > 0.0;
+        } else if (key == "speed") {
+            ok = readRange(text.c_str(), cfg.minSpeed, cfg.maxSpeed) &&
+                 cfg.minSpeed >= 0.0;
+        } else if (key == "velocity") {
+            if (text == "uniform")       cfg.velocity = VelocityDistribution::Uniform;
+            else if (text == "gaussian") cfg.velocity = VelocityDistribution::Gaussian;
+            else ok = false;
+        } else if (key == "layout") {
+            if (text == "uniform")      cfg.layout = LayoutDistribution::Uniform;
+            else if (text == "cluster") cfg.layout = LayoutDistribution::Cluster;
+            else ok = false;
+        } else if (key == "spread") {
+            ok = readValue(text.c_str(), cfg.spread) && cfg.spread > 0.0;
+        } else if (key == "density") {
+            ok = readValue(text.c_str(), cfg.density) && cfg.density > 0.0;
+        } else {
+            error = "clave desconocida en 'generate': " + key;
+            return false;
+        }
+        if (!ok) {
+            error = "valor inválido para '" + key + "': " + text;
+            return false;
+        }
+    }
+    if (!hasCount) {
+        error = "'generate' necesita count=<n>";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool loadScenario(const std::string& path, Simulation& sim, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    std::string line;
+    std::size_t lineNo = 0;
+    auto fail = [&](const std::string& what) {
+        error = path + ":" + std::to_string(lineNo) + ": " + what;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        const char* p = line.c_str();
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (!*p) continue;
+
+        const char* wordEnd = p;
+        while (*wordEnd && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r') ++wordEnd;
+        std::size_t len = static_cast<std::size_t>(wordEnd - p);
+        auto is = [&](const char* word) {
+            return std::strlen(word) == len && std::strncmp(p, word, len) == 0;
+        };
+        const char* args = wordEnd;
+
+        double v[7];
+        if (is("particle")) {
+            for (double& value : v) {
+                if (!readNumber(args, value)) return fail("'particle' necesita id x y vx vy masa radio");
+            }
+            for (double value : v) {
+                if (!std::isfinite(value)) return fail("'particle' tiene un valor no finito");
+            }
+            if (v[0] != std::floor(v[0]) || std::abs(v[0]) > 2147483647.0)
+                return fail("el id de 'particle' debe ser un entero");
+            if (!(v[5] > 0.0) || !(v[6] > 0.0))
+                return fail("'particle' necesita masa y radio positivos");
+            std::size_t slot;
+            if (sim.particles.findId(static_cast<int>(v[0]), slot))
+                return fail("id de partícula repetido: " + std::to_string(static_cast<int>(v[0])));
+            sim.addParticle(Particle(static_cast<int>(v[0]), Vec2(v[1], v[2]),
+                                     Vec2(v[3], v[4]), v[5], v[6]));
+        } else if (is("obstacle")) {
+            for (int k = 0; k < 3; ++k) {
+                if (!readNumber(args, v[k])) return fail("'obstacle' necesita cx cy halfSize");
+            }
+            sim.addObstacle(Obstacle(Vec2(v[0], v[1]), v[2]));
+        } else if (is("box")) {
+            if (!readNumber(args, v[0]) || !readNumber(args, v[1]))
+                return fail("'box' necesita ancho y alto");
+            if (!(v[0] > 0.0) || !(v[1] > 0.0) || !std::isfinite(v[0]) || !std::isfinite(v[1]))
+                return fail("'box' necesita ancho y alto positivos");
+            sim.box.width = v[0];
+            sim.box.height = v[1];
+        } else if (is("dt")) {
+            if (!readNumber(args, v[0])) return fail("'dt' necesita un valor");
+            if (!(v[0] > 0.0) || !std::isfinite(v[0])) return fail("'dt' debe ser positivo");
+            sim.dt = v[0];
+        } else if (is("totalTime")) {
+            if (!readNumber(args, v[0])) return fail("'totalTime' necesita un valor");
+            if (!(v[0] >= 0.0) || !std::isfinite(v[0])) return fail("'totalTime' no puede ser negativo");
+            sim.totalTime = v[0];
+        } else if (is("restitution")) {
+            if (!readNumber(args, v[0])) return fail("'restitution' necesita un valor");
+            if (!(v[0] >= 0.0 && v[0] <= 1.0)) return fail("'restitution' debe estar entre 0 y 1");
+            sim.obstacleRestitution = v[0];
+        } else if (is("particles")) {
+            if (!readNumber(args, v[0])) return fail("'particles' necesita una cantidad");
+            if (!(v[0] >= 0.0) || v[0] != std::floor(v[0]) || v[0] > kMaxParticles)
+                return fail("'particles' necesita un entero entre 0 y 100000000");
+            sim.particles.reserve(static_cast<std::size_t>(v[0]));
+        } else if (is("generate")) {
+            GeneratorConfig cfg;
+            std::string why;
+            if (!parseGenerate(args, cfg, why)) return fail(why);
+            std::size_t placed = generateParticles(sim, cfg);
+            if (placed < cfg.count) {
+                std::cerr << "Aviso: solo se ubicaron " << placed << " de "
+                          << cfg.count << " partículas\n";
+            }
+        } else {
+            return fail("directiva desconocida: " + std::string(p, wordEnd));
+        }
+    }
+    return true;
+}
+
+std::size_t generateParticles(Simulation& sim, const GeneratorConfig& cfg) {
+    ParticleStore& store = sim.particles;
+    double width = sim.box.width;
+    double height = sim.box.height;
+
+    Random rng(cfg.seed);
+
+    // Las que ya estaban también cuentan para no superponerse
+    double rmax = cfg.maxRadius;
+    int nextId = 0;
+    for (std::size_t s = 0; s < store.size(); ++s) {
+        if (store.active[s]) rmax = std::max<double>(rmax, store.radius[s]);
+        nextId = std::max(nextId, store.id[s] + 1);
+    }
+    if (rmax <= 0.0) return 0;
+
+    PlacementGrid grid(width, height, 2.0 * rmax, store.liveCount() + cfg.count);
+    for (std::size_t s = 0; s < store.liveCount(); ++s) {
+        if (store.active[s]) grid.insert(store.x[s], store.y[s], store.radius[s]);
+    }
+
+    ObstacleIndex obstacleIndex;
+    obstacleIndex.build(sim.obstacles, width, height);
+    std::vector<std::size_t> near;
+
+    store.reserve(store.size() + cfg.count);
+
+    std::size_t placed = 0;
+    for (; placed < cfg.count; ++placed) {
+        double r = rng.uniform(cfg.minRadius, cfg.maxRadius);
+        if (2.0 * r > width || 2.0 * r > height) break;
+
+        bool found = false;
+        double px = 0.0;
+        double py = 0.0;
+        for (int attempt = 0; attempt < cfg.maxAttempts && !found; ++attempt) {
+            if (cfg.layout == LayoutDistribution::Cluster) {
+                px = 0.5 * width  + rng.normal() * cfg.spread * width;
+                py = 0.5 * height + rng.normal() * cfg.spread * height;
+                if (px < r || px > width - r || py < r || py > height - r) continue;
+            } else {
+                px = rng.uniform(r, width - r);
+                py = rng.uniform(r, height - r);
+            }
+
+            if (grid.overlaps(px, py, r)) continue;
+
+            bool hitsObstacle = false;
+            obstacleIndex.query(px, py, r, near);
+            for (std::size_t j : near) {
+                Vec2 normal;
+                if (sim.obstacles[j].checkCollision(px, py, r, normal)) {
+                    hitsObstacle = true;
+                    break;
+                }
+            }
+            found = !hitsObstacle;
+        }
+        if (!found) break; // la caja está demasiado llena
+
+        double vx;
+        double vy;
+        if (cfg.velocity == VelocityDistribution::Gaussian) {
+            vx = rng.normal() * cfg.maxSpeed;
+            vy = rng.normal() * cfg.maxSpeed;
+        } else {
+            double angle = rng.uniform(0.0, 2.0 * kPi);
+            double speed = rng.uniform(cfg.minSpeed, cfg.maxSpeed);
+            vx = speed * std::cos(angle);
+            vy = speed * std::sin(angle);
+        }
+
+        grid.insert(px, py, r);
+        sim.addParticle(Particle(nextId++, Vec2(px, py), Vec2(vx, vy),
+                                 cfg.density * kPi * r * r, r));
+    }
+    return placed;
+}
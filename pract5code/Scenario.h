@@ -0,0 +1,61 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Simulation;
+
+// Carga de escenarios desde archivo. Formato de texto, una directiva por
+// línea ('#' inicia un comentario):
+//
+//   box <ancho> <alto>
+//   dt <dt>
+//   totalTime <tiempo>
+//   restitution <e>
+//   particles <n>                        (opcional: reserva memoria)
+//   particle <id> <x> <y> <vx> <vy> <masa> <radio>
+//   obstacle <cx> <cy> <halfSize>
+//   generate count=<n> [seed=<s>] [radius=<min>:<max>] [speed=<min>:<max>]
+//            [velocity=uniform|gaussian] [layout=uniform|cluster]
+//            [spread=<f>] [density=<d>]
+//
+// Las partículas se agregan a medida que se leen, sin armar listas
+// intermedias. 'generate' agrega partículas con generateParticles() usando
+// la caja y los obstáculos definidos hasta esa línea.
+//
+// Devuelve false y deja el motivo en 'error' si algo falla.
+bool loadScenario(const std::string& path, Simulation& sim, std::string& error);
+
+
+enum class VelocityDistribution {
+    Uniform,    // dirección al azar, rapidez uniforme en [minSpeed, maxSpeed]
+    Gaussian    // componentes normales con sigma = maxSpeed (Maxwell 2D)
+};
+
+enum class LayoutDistribution {
+    Uniform,    // toda la caja
+    Cluster     // normal alrededor del centro, sigma = spread * lado
+};
+
+struct GeneratorConfig {
+    std::size_t count = 1000;
+    std::uint64_t seed = 1;
+    double minRadius = 0.5;
+    double maxRadius = 1.0;
+    double minSpeed = 0.0;
+    double maxSpeed = 10.0;
+    VelocityDistribution velocity = VelocityDistribution::Uniform;
+    LayoutDistribution layout = LayoutDistribution::Uniform;
+    double spread = 0.15;
+    double density = 0.1;       // masa = density * pi * r^2
+    int maxAttempts = 64;       // intentos por partícula antes de rendirse
+};
+
+// Llena la caja de 'sim' con partículas que no se tocan entre sí, ni con las
+// que ya estaban, ni con los obstáculos. Misma semilla = mismo escenario.
+// Devuelve cuántas pudo ubicar (menos que count si la caja se llenó).
+std::size_t generateParticles(Simulation& sim, const GeneratorConfig& config);
+
+#endif // SCENARIO_H
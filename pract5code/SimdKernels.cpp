@@ -0,0 +1,325 @@
+#include "SimdKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define P5_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+// ---------------------------------------------------------------- escalar
+
+template <typename T>
+static void integrateScalar(T* x, T* y, const T* vx, const T* vy,
+                            std::size_t begin, std::size_t end, T dt) {
+    for (std::size_t i = begin; i < end; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+template <typename T>
+static inline std::uint8_t reflectOne(T& x, T& y, T& vx, T& vy,
+                                      T r, T width, T height) {
+    std::uint8_t mask = 0;
+
+    // Paredes izquierda y derecha (x=0 y x=width)
+    if (x - r < T(0)) {
+        x = r; // Corrige penetración
+        vx = -vx;
+        mask |= HitLeft;
+    } else if (x + r > width) {
+        x = width - r;
+        vx = -vx;
+        mask |= HitRight;
+    }
+
+    // Paredes inferior y superior (y=0 y y=height)
+    if (y - r < T(0)) {
+        y = r;
+        vy = -vy;
+        mask |= HitBottom;
+    } else if (y + r > height) {
+        y = height - r;
+        vy = -vy;
+        mask |= HitTop;
+    }
+    return mask;
+}
+
+template <typename T>
+static std::size_t reflectWallsScalar(T* x, T* y, T* vx, T* vy,
+                                      const T* radius,
+                                      std::size_t begin, std::size_t end,
+                                      T width, T height,
+                                      std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+    std::size_t hits = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        std::uint8_t mask = reflectOne(x[i], y[i], vx[i], vy[i], radius[i], width, height);
+        if (mask) {
+            hitIndex[hits] = static_cast<std::uint32_t>(i);
+            hitMask[hits] = mask;
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+// ------------------------------------------------------------------- AVX2
+
+#ifdef P5_HAVE_AVX2
+
+__attribute__((target("avx2")))
+static void integrateAvx2(double* x, double* y, const double* vx, const double* vy,
+                          std::size_t begin, std::size_t end, double dt) {
+    __m256d step = _mm256_set1_pd(dt);
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d px = _mm256_loadu_pd(x + i);
+        __m256d py = _mm256_loadu_pd(y + i);
+        px = _mm256_add_pd(px, _mm256_mul_pd(_mm256_loadu_pd(vx + i), step));
+        py = _mm256_add_pd(py, _mm256_mul_pd(_mm256_loadu_pd(vy + i), step));
+        _mm256_storeu_pd(x + i, px);
+        _mm256_storeu_pd(y + i, py);
+    }
+    integrateScalar(x, y, vx, vy, i, end, dt);
+}
+
+// Un eje: devuelve las máscaras de pared baja (min) y alta (max) por carril
+__attribute__((target("avx2")))
+static inline void reflectAxis(__m256d& p, __m256d& v, __m256d r, __m256d limit,
+                               int& lowBits, int& highBits) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    // Igual que la versión escalar: 'else if', la pared baja tiene prioridad
+    __m256d low  = _mm256_cmp_pd(_mm256_sub_pd(p, r), zero, _CMP_LT_OQ);
+    __m256d high = _mm256_andnot_pd(low,
+                       _mm256_cmp_pd(_mm256_add_pd(p, r), limit, _CMP_GT_OQ));
+
+    lowBits  = _mm256_movemask_pd(low);
+    highBits = _mm256_movemask_pd(high);
+    if ((lowBits | highBits) == 0) return;
+
+    p = _mm256_blendv_pd(p, r, low);
+    p = _mm256_blendv_pd(p, _mm256_sub_pd(limit, r), high);
+    v = _mm256_blendv_pd(v, _mm256_xor_pd(v, sign), _mm256_or_pd(low, high));
+}
+
+__attribute__((target("avx2")))
+static std::size_t reflectWallsAvx2(double* x, double* y, double* vx, double* vy,
+                                    const double* radius,
+                                    std::size_t begin, std::size_t end,
+                                    double width, double height,
+                                    std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+    const __m256d w = _mm256_set1_pd(width);
+    const __m256d h = _mm256_set1_pd(height);
+
+    std::size_t hits = 0;
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d r  = _mm256_loadu_pd(radius + i);
+        __m256d px = _mm256_loadu_pd(x + i);
+        __m256d pv = _mm256_loadu_pd(vx + i);
+        __m256d py = _mm256_loadu_pd(y + i);
+        __m256d pw = _mm256_loadu_pd(vy + i);
+
+        int left, right, bottom, top;
+        reflectAxis(px, pv, r, w, left, right);
+        reflectAxis(py, pw, r, h, bottom, top);
+
+        int any = left | right | bottom | top;
+        if (any == 0) continue; // caso común: nadie toca una pared
+
+        _mm256_storeu_pd(x + i, px);
+        _mm256_storeu_pd(vx + i, pv);
+        _mm256_storeu_pd(y + i, py);
+        _mm256_storeu_pd(vy + i, pw);
+
+        for (int lane = 0; lane < 4; ++lane) {
+            int bit = 1 << lane;
+            if (!(any & bit)) continue;
+            std::uint8_t mask = 0;
+            if (left & bit)   mask |= HitLeft;
+            if (right & bit)  mask |= HitRight;
+            if (bottom & bit) mask |= HitBottom;
+            if (top & bit)    mask |= HitTop;
+            hitIndex[hits] = static_cast<std::uint32_t>(i + lane);
+            hitMask[hits] = mask;
+            ++hits;
+        }
+    }
+
+    return hits + reflectWallsScalar(x, y, vx, vy, radius, i, end, width, height,
+                                     hitIndex + hits, hitMask + hits);
+}
+
+// Versión float: 8 partículas por instrucción, mismas operaciones
+
+__attribute__((target("avx2")))
+static void integrateAvx2(float* x, float* y, const float* vx, const float* vy,
+                          std::size_t begin, std::size_t end, float dt) {
+    __m256 step = _mm256_set1_ps(dt);
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        px = _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(vx + i), step));
+        py = _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(vy + i), step));
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(y + i, py);
+    }
+    integrateScalar(x, y, vx, vy, i, end, dt);
+}
+
+__attribute__((target("avx2")))
+static inline void reflectAxis(__m256& p, __m256& v, __m256 r, __m256 limit,
+                               int& lowBits, int& highBits) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    __m256 low  = _mm256_cmp_ps(_mm256_sub_ps(p, r), zero, _CMP_LT_OQ);
+    __m256 high = _mm256_andnot_ps(low,
+                      _mm256_cmp_ps(_mm256_add_ps(p, r), limit, _CMP_GT_OQ));
+
+    lowBits  = _mm256_movemask_ps(low);
+    highBits = _mm256_movemask_ps(high);
+    if ((lowBits | highBits) == 0) return;
+
+    p = _mm256_blendv_ps(p, r, low);
+    p = _mm256_blendv_ps(p, _mm256_sub_ps(limit, r), high);
+    v = _mm256_blendv_ps(v, _mm256_xor_ps(v, sign), _mm256_or_ps(low, high));
+}
+
+__attribute__((target("avx2")))
+static std::size_t reflectWallsAvx2(float* x, float* y, float* vx, float* vy,
+                                    const float* radius,
+                                    std::size_t begin, std::size_t end,
+                                    float width, float height,
+                                    std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+    const __m256 w = _mm256_set1_ps(width);
+    const __m256 h = _mm256_set1_ps(height);
+
+    std::size_t hits = 0;
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 r  = _mm256_loadu_ps(radius + i);
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 pv = _mm256_loadu_ps(vx + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 pw = _mm256_loadu_ps(vy + i);
+
+        int left, right, bottom, top;
+        reflectAxis(px, pv, r, w, left, right);
+        reflectAxis(py, pw, r, h, bottom, top);
+
+        int any = left | right | bottom | top;
+        if (any == 0) continue;
+
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(vx + i, pv);
+        _mm256_storeu_ps(y + i, py);
+        _mm256_storeu_ps(vy + i, pw);
+
+        for (int lane = 0; lane < 8; ++lane) {
+            int bit = 1 << lane;
+            if (!(any & bit)) continue;
+            std::uint8_t mask = 0;
+            if (left & bit)   mask |= HitLeft;
+            if (right & bit)  mask |= HitRight;
+            if (bottom & bit) mask |= HitBottom;
+            if (top & bit)    mask |= HitTop;
+            hitIndex[hits] = static_cast<std::uint32_t>(i + lane);
+            hitMask[hits] = mask;
+            ++hits;
+        }
+    }
+
+    return hits + reflectWallsScalar(x, y, vx, vy, radius, i, end, width, height,
+                                     hitIndex + hits, hitMask + hits);
+}
+
+static bool cpuHasAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // P5_HAVE_AVX2
+
+// ------------------------------------------------------------- despacho
+
+static bool scalarForced = false;
+
+static bool useAvx2() {
+#ifdef P5_HAVE_AVX2
+    static const bool available = cpuHasAvx2();
+    return available && !scalarForced;
+#else
+    return false;
+#endif
+}
+
+template <typename T>
+static void integrateDispatch(T* x, T* y, const T* vx, const T* vy,
+                              std::size_t begin, std::size_t end, T dt) {
+#ifdef P5_HAVE_AVX2
+    if (useAvx2()) {
+        integrateAvx2(x, y, vx, vy, begin, end, dt);
+        return;
+    }
+#endif
+    integrateScalar(x, y, vx, vy, begin, end, dt);
+}
+
+template <typename T>
+static std::size_t reflectWallsDispatch(T* x, T* y, T* vx, T* vy, const T* radius,
+                                        std::size_t begin, std::size_t end,
+                                        T width, T height,
+                                        std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+#ifdef P5_HAVE_AVX2
+    if (useAvx2()) {
+        return reflectWallsAvx2(x, y, vx, vy, radius, begin, end, width, height,
+                                hitIndex, hitMask);
+    }
+#endif
+    return reflectWallsScalar(x, y, vx, vy, radius, begin, end, width, height,
+                              hitIndex, hitMask);
+}
+
+void integrate(double* x, double* y, const double* vx, const double* vy,
+               std::size_t begin, std::size_t end, double dt) {
+    integrateDispatch(x, y, vx, vy, begin, end, dt);
+}
+
+void integrate(float* x, float* y, const float* vx, const float* vy,
+               std::size_t begin, std::size_t end, float dt) {
+    integrateDispatch(x, y, vx, vy, begin, end, dt);
+}
+
+std::size_t reflectWalls(double* x, double* y, double* vx, double* vy,
+                         const double* radius,
+                         std::size_t begin, std::size_t end,
+                         double width, double height,
+                         std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+    return reflectWallsDispatch(x, y, vx, vy, radius, begin, end, width, height,
+                                hitIndex, hitMask);
+}
+
+std::size_t reflectWalls(float* x, float* y, float* vx, float* vy,
+                         const float* radius,
+                         std::size_t begin, std::size_t end,
+                         float width, float height,
+                         std::uint32_t* hitIndex, std::uint8_t* hitMask) {
+    return reflectWallsDispatch(x, y, vx, vy, radius, begin, end, width, height,
+                                hitIndex, hitMask);
+}
+
+const char* activeIsa() {
+    return useAvx2() ? "avx2" : "scalar";
+}
+
+void forceScalar(bool scalarOnly) {
+    scalarForced = scalarOnly;
+}
+
+} // namespace kernels
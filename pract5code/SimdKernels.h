@@ -0,0 +1,52 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels por lotes sobre las columnas de ParticleStore, en double o float
+// (ver Scalar.h). Hay una versión AVX2 (4 doubles u 8 floats por
+// instrucción) y una escalar; la AVX2 se elige en
+// tiempo de ejecución si el procesador la soporta. Ambas hacen exactamente
+// las mismas operaciones, así que dan resultados idénticos bit a bit.
+namespace kernels {
+
+// Bits de la máscara de colisión con paredes
+enum WallBits : std::uint8_t {
+    HitLeft   = 1,  // MURO_IZQ
+    HitRight  = 2,  // MURO_DER
+    HitBottom = 4,  // MURO_ABAJ
+    HitTop    = 8   // MURO_ARR
+};
+
+// x += vx*dt, y += vy*dt para i en [begin, end)
+void integrate(double* x, double* y, const double* vx, const double* vy,
+               std::size_t begin, std::size_t end, double dt);
+void integrate(float* x, float* y, const float* vx, const float* vy,
+               std::size_t begin, std::size_t end, float dt);
+
+// Refleja contra las paredes de la caja [0,width] x [0,height] a las
+// partículas en [begin, end). No escribe nada en el log: devuelve la
+// cantidad de partículas que chocaron y deja sus índices (en orden
+// creciente) en hitIndex y las paredes tocadas en hitMask. Ambos arreglos
+// deben tener lugar para end - begin elementos.
+std::size_t reflectWalls(double* x, double* y, double* vx, double* vy,
+                         const double* radius,
+                         std::size_t begin, std::size_t end,
+                         double width, double height,
+                         std::uint32_t* hitIndex, std::uint8_t* hitMask);
+std::size_t reflectWalls(float* x, float* y, float* vx, float* vy,
+                         const float* radius,
+                         std::size_t begin, std::size_t end,
+                         float width, float height,
+                         std::uint32_t* hitIndex, std::uint8_t* hitMask);
+
+// "avx2" o "scalar", según lo que se esté usando
+const char* activeIsa();
+
+// Obliga a usar la versión escalar (para comparar)
+void forceScalar(bool scalarOnly);
+
+} // namespace kernels
+
+#endif // SIMDKERNELS_H
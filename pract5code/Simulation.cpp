@@ -1,7 +1,15 @@
 #include "Simulation.h"
-#include <fstream>
+#include "AsyncTrajectoryWriter.h"
+#include "ThreadPool.h"
+#include "SimdKernels.h"
+#include "EventDrivenEngine.h"
+#include "Checkpoint.h"
+#include "EventSink.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <memory>
+#include <limits>
 
 Simulation::Simulation(double width, double height,
                        double dt_, double totalTime_,
@@ -9,135 +17,683 @@ Simulation::Simulation(double width, double height,
     : box(width, height),
     dt(dt_),
     totalTime(totalTime_),
-    obstacleRestitution(e_)
+    obstacleRestitution(e_),
+    useSpatialGrid(true),
+    useObstacleIndex(true),
+    outputFormat(OutputFormat::Text),
+    keyframeEvery(50),
+    textIndex(false),
+    asyncOutput(true),
+    numThreads(1),
+    engine(SimulationEngine::FixedStep),
+    mergeMode(MergeMode::Sequential),
+    reorderEvery(0),
+    reorderThreshold(0.1),
+    verbose(true),
+    adaptiveStep(false),
+    minDt(1e-6),
+    maxDt(std::numeric_limits<double>::infinity()),
+    stepSafety(0.5),
+    profile(nullptr),
+    eventSink(nullptr),
+    startStep(0),
+    checkpointEvery(0),
+    pool(nullptr),
+    numChunks(1),
+    pairsOrdered(true)
 {
 }
 
 void Simulation::addParticle(const Particle& p) {
-    particles.push_back(p);
+    particles.add(p);
 }
 
 void Simulation::addObstacle(const Obstacle& o) {
     obstacles.push_back(o);
 }
 
-void Simulation::run(const std::string& outputFile) {
-    std::ofstream log(outputFile);
-    if (!log) {
-        std::cerr << "No se pudo abrir el archivo de salida\n";
-        return;
+bool Simulation::run(const std::string& outputFile) {
+    std::unique_ptr<TrajectoryWriter> log =
+        TrajectoryWriter::create(outputFormat, keyframeEvery, textIndex);
+    if (asyncOutput && log->needsFrames()) {
+        log.reset(new AsyncTrajectoryWriter(std::move(log)));
+    }
+    if (!log->open(outputFile)) {
+        std::cerr << "No se pudo abrir el archivo de salida " << outputFile << "\n";
+        return false;
+    }
+
+    // Con varios hilos cada fase se parte en bloques fijos; el resultado no
+    // depende de cuántos hilos haya porque los eventos se juntan por bloque.
+    std::unique_ptr<ThreadPool> threads;
+    if (numThreads > 1) {
+        threads.reset(new ThreadPool(numThreads));
+        numChunks = 4 * static_cast<std::size_t>(numThreads);
+    } else {
+        numChunks = 1;
+    }
+    pool = threads.get();
+    chunkEvents.assign(numChunks, std::vector<CollisionEvent>());
+    chunkWallHits.assign(numChunks, WallHits());
+    chunkScratch.assign(numChunks, std::vector<std::size_t>());
+    chunkTests.assign(numChunks, 0);
+    chunkPairs.assign(numChunks, std::vector<std::size_t>());
+
+    // Los obstáculos no se mueven: el índice se arma una vez
+    if (useObstacleIndex) {
+        obstacleIndex.build(obstacles, box.width, box.height);
+    }
+
+    log->writeHeader(particles.size(), dt, totalTime, box);
+
+    bool ok = true;
+    if (engine == SimulationEngine::EventDriven) {
+        EventDrivenEngine(*this).run(*log);
+    } else {
+        ok = runFixedStep(*log);
     }
 
-    log << "# numParticles dt totalTime\n";
-    log << particles.size() << " " << dt << " " << totalTime << "\n\n";
+    log->close();
+    if (eventSink) eventSink->finish();
+    if (profile) profile->bytesWritten += log->bytesWritten();
+    pool = nullptr;
+    if (verbose) {
+        if (log->needsFrames()) {
+            std::cout << "Simulación terminada. Resultados en " << outputFile << "\n";
+        } else {
+            std::cout << "Simulación terminada (sin archivo de salida)\n";
+        }
+    }
+    return ok;
+}
 
+void Simulation::recordStep(TrajectoryWriter& log, double time,
+                            const std::vector<CollisionEvent>& stepEvents) {
+    if (log.needsFrames()) {
+        log.beginStep().capture(time, particles, stepEvents);
+        log.commitStep();
+    }
+    if (eventSink) eventSink->consume(time, stepEvents.data(), stepEvents.size());
+}
+
+bool Simulation::runFixedStep(TrajectoryWriter& log) {
+    bool ok = true;
     double time = 0.0;
     int steps = static_cast<int>(totalTime / dt);
 
-    for (int step = 0; step <= steps; ++step) {
+    for (int step = startStep; step <= steps; ++step) {
         time = step * dt;
+        events.clear();
 
-        // 1. Actualizar posiciones
-        for (auto& p : particles) {
-            if (!p.active) continue;
-            p.update(dt);
+        if (reorderEvery > 0 && step % reorderEvery == 0) {
+            PhaseTimer timer(profile, Phase::Reorder);
+            maybeReorder();
         }
 
-        // 2. Colisiones con paredes
-        for (auto& p : particles) {
-            box.handleWallCollision(p, log, time);
+        // Con paso adaptivo el intervalo de registro se parte en subpasos
+        // iguales; el registro sigue siendo cada dt. Si alcanza con uno,
+        // h == dt y el paso es idéntico al fijo.
+        int substeps = adaptiveStep ? substepsFor(dt) : 1;
+        double h = dt / substeps;
+        for (int sub = 0; sub < substeps; ++sub) {
+            advance(time + sub * h, h);
         }
 
-        // 3. Colisiones partícula-obstáculo
-        handleParticleObstacleCollisions(log, time);
+        // 5. Registrar estado
+        {
+            PhaseTimer timer(profile, Phase::Logging);
+            recordStep(log, time, events);
+        }
 
-        // 4. Colisiones partícula-partícula (inelásticas, fusión)
-        handleParticleParticleCollisions(log, time);
+        // 6. Punto de control: el estado ya incluye este paso
+        if (checkpointEvery > 0 && (step + 1) % checkpointEvery == 0 &&
+            !checkpointFile.empty()) {
+            std::string error;
+            if (!saveCheckpoint(*this, step + 1, checkpointFile, error)) {
+                std::cerr << "No se pudo guardar el punto de control: "
+                          << error << "\n";
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
 
-        // 5. Registrar estado
-        logState(log, time);
+void Simulation::advance(double time, double h) {
+    if (profile) {
+        profile->steps++;
+        profile->particleSteps += particles.liveCount();
     }
 
-    log.close();
-    std::cout << "Simulación terminada. Resultados en " << outputFile << "\n";
+    // 1. Actualizar posiciones (solo el rango vivo)
+    {
+        PhaseTimer timer(profile, Phase::Integrate);
+        integratePositions(h);
+    }
+
+    // 2. Colisiones con paredes
+    std::size_t eventsBefore = events.size();
+    {
+        PhaseTimer timer(profile, Phase::Walls);
+        handleWallCollisions(time);
+    }
+    if (profile) profile->wallHits += events.size() - eventsBefore;
+
+    // 3. Colisiones partícula-obstáculo
+    eventsBefore = events.size();
+    {
+        PhaseTimer timer(profile, Phase::Obstacles);
+        handleParticleObstacleCollisions(time);
+    }
+    if (profile) profile->obstacleHits += events.size() - eventsBefore;
+
+    // 4. Colisiones partícula-partícula (inelásticas, fusión)
+    eventsBefore = events.size();
+    {
+        PhaseTimer timer(profile, Phase::Pairs);
+        handleParticleParticleCollisions(time);
+        particles.compact();
+    }
+    if (profile) profile->merges += events.size() - eventsBefore;
 }
 
-void Simulation::handleParticleObstacleCollisions(std::ofstream& log, double time) {
-    for (std::size_t i = 0; i < particles.size(); ++i) {
-        Particle& p = particles[i];
-        if (!p.active) continue;
+int Simulation::substepsFor(double interval) const {
+    // Tamaño más chico que no hay que saltear: el menor radio vivo o el
+    // menor obstáculo
+    double feature = std::numeric_limits<double>::infinity();
+    double maxSpeed2 = 0.0;
+    std::size_t n = particles.liveCount();
+    for (std::size_t i = 0; i < n; ++i) {
+        double v2 = particles.vx[i] * particles.vx[i] + particles.vy[i] * particles.vy[i];
+        maxSpeed2 = std::max(maxSpeed2, v2);
+        feature = std::min<double>(feature, particles.radius[i]);
+    }
+    for (const Obstacle& o : obstacles) {
+        feature = std::min(feature, o.halfSize);
+    }
+    if (maxSpeed2 <= 0.0 || !std::isfinite(feature)) return 1;
+
+    // Ninguna partícula avanza más que stepSafety * feature por subpaso
+    double h = stepSafety * feature / std::sqrt(maxSpeed2);
+    h = std::min(std::max(h, minDt), maxDt);
+    if (!(h < interval)) return 1;
+
+    double count = std::ceil(interval / h);
+    double limit = std::ceil(interval / minDt);
+    count = std::min(count, limit);
+    // Convertir a int algo que no entra es indefinido
+    double maxCount = static_cast<double>(std::numeric_limits<int>::max());
+    return static_cast<int>(std::min(count, maxCount));
+}
 
-        for (std::size_t j = 0; j < obstacles.size(); ++j) {
+template <typename F>
+void Simulation::forEachChunk(std::size_t n, F&& f) {
+    if (!pool) {
+        f(std::size_t(0), n, std::size_t(0));
+        return;
+    }
+    pool->parallelFor(n, numChunks, f);
+}
+
+std::uint64_t Simulation::takeChunkTests() {
+    std::uint64_t total = 0;
+    for (std::uint64_t& tests : chunkTests) {
+        total += tests;
+        tests = 0;
+    }
+    return total;
+}
+
+void Simulation::appendChunkEvents() {
+    if (!pool) return;
+    for (auto& chunk : chunkEvents) {
+        events.insert(events.end(), chunk.begin(), chunk.end());
+        chunk.clear();
+    }
+}
+
+void Simulation::integratePositions(double h) {
+    Scalar* x = particles.x.data();
+    Scalar* y = particles.y.data();
+    const Scalar* vx = particles.vx.data();
+    const Scalar* vy = particles.vy.data();
+    Scalar step = static_cast<Scalar>(h);
+
+    forEachChunk(particles.liveCount(),
+                 [=](std::size_t begin, std::size_t end, std::size_t) {
+        kernels::integrate(x, y, vx, vy, begin, end, step);
+    });
+}
+
+void Simulation::handleWallCollisions(double time) {
+    forEachChunk(particles.liveCount(),
+                 [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        box.reflectWalls(particles, begin, end, chunkWallHits[chunk]);
+    });
+
+    // Los eventos se arman después, fuera del ciclo, en orden de slot
+    std::size_t first = events.size();
+    for (WallHits& hits : chunkWallHits) {
+        Box::appendWallEvents(particles, hits, time, events);
+        hits.count = 0;
+    }
+    sortEventsByHandle(first);
+}
+
+void Simulation::handleParticleObstacleCollisions(double time) {
+    std::size_t first = events.size();
+    forEachChunk(particles.liveCount(),
+                 [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        std::vector<CollisionEvent>& out = pool ? chunkEvents[chunk] : events;
+        std::vector<std::size_t>& near = chunkScratch[chunk];
+        std::uint64_t tests = 0;
+
+        for (std::size_t i = begin; i < end; ++i) {
             Vec2 normal;
-            if (obstacles[j].checkCollision(p, normal)) {
-                // Descomponer velocidad en componentes normal y tangencial
-                Vec2 v = p.velocity;
-                double v_n_scalar = v.dot(normal);
-                Vec2 v_n = normal * v_n_scalar;
-                Vec2 v_t = v - v_n;
-
-                // Aplicar coeficiente de restitución a la componente normal
-                Vec2 v_n_prime = normal * (-obstacleRestitution * v_n_scalar);
-                p.velocity = v_n_prime + v_t;
-
-                log << "COLLISION_PO " << time << " " << p.id
-                    << " OBSTACLE " << j << "\n";
+
+            if (!useObstacleIndex) {
+                tests += obstacles.size();
+                for (std::size_t j = 0; j < obstacles.size(); ++j) {
+                    if (obstacles[j].checkCollision(particles.x[i], particles.y[i],
+                                                    particles.radius[i], normal)) {
+                        bounceOffObstacle(i, j, normal, time, out);
+                    }
+                }
+                continue;
+            }
+
+            // Solo los obstáculos cercanos, en orden creciente de índice
+            // (mismo orden de rebotes y eventos que probando todos)
+            obstacleIndex.query(particles.x[i], particles.y[i],
+                                particles.radius[i], near);
+            tests += near.size();
+            for (std::size_t j : near) {
+                if (obstacles[j].checkCollision(particles.x[i], particles.y[i],
+                                                particles.radius[i], normal)) {
+                    bounceOffObstacle(i, j, normal, time, out);
+                }
             }
         }
+        chunkTests[chunk] += tests;
+    });
+    appendChunkEvents();
+    sortEventsByHandle(first);
+    std::uint64_t tests = takeChunkTests();
+    if (profile) profile->obstacleTests += tests;
+}
+
+void Simulation::bounceOffObstacle(std::size_t i, std::size_t j, const Vec2& normal,
+                                   double time, std::vector<CollisionEvent>& out) {
+    // Descomponer velocidad en componentes normal y tangencial
+    Vec2 v(particles.vx[i], particles.vy[i]);
+    double v_n_scalar = v.dot(normal);
+    Vec2 v_n = normal * v_n_scalar;
+    Vec2 v_t = v - v_n;
+
+    // Aplicar coeficiente de restitución a la componente normal
+    Vec2 v_n_prime = normal * (-obstacleRestitution * v_n_scalar);
+    Vec2 v_new = v_n_prime + v_t;
+    particles.vx[i] = v_new.x;
+    particles.vy[i] = v_new.y;
+
+    out.push_back({time, CollisionKind::Obstacle, particles.id[i],
+                   static_cast<std::int32_t>(j), -1});
+}
+
+void Simulation::sortEventsByHandle(std::size_t first) {
+    if (particles.inHandleOrder() || events.size() - first < 2) return;
+
+    // Orden estable por handle de la partícula: el mismo que con el
+    // almacenamiento en orden de inserción
+    eventKeys.clear();
+    for (std::size_t k = first; k < events.size(); ++k) {
+        std::size_t slot = 0;
+        particles.findId(events[k].particle, slot);
+        eventKeys.push_back({particles.handle[slot], k});
     }
+    std::sort(eventKeys.begin(), eventKeys.end());
+    eventScratch.clear();
+    for (const auto& key : eventKeys) {
+        eventScratch.push_back(events[key.second]);
+    }
+    std::copy(eventScratch.begin(), eventScratch.end(), events.begin() + first);
 }
 
-void Simulation::handleParticleParticleCollisions(std::ofstream& log, double time) {
-    std::size_t n = particles.size();
+void Simulation::rankByHandle() {
+    pairsOrdered = particles.inHandleOrder();
+    if (pairsOrdered) return;
 
-    for (std::size_t i = 0; i < n; ++i) {
-        Particle& a = particles[i];
-        if (!a.active) continue;
+    // Recorrer los handles en orden y quedarse con los slots vivos
+    std::size_t n = particles.liveCount();
+    rankSlot.clear();
+    slotRank.resize(n);
+    for (std::size_t h = 0; h < particles.size(); ++h) {
+        std::size_t slot = particles.slotOfHandle(h);
+        if (slot >= n) continue;
+        slotRank[slot] = rankSlot.size();
+        rankSlot.push_back(slot);
+    }
+}
 
+void Simulation::sortByRank(std::size_t fromRank,
+                            std::vector<std::size_t>& slots) const {
+    std::size_t kept = 0;
+    for (std::size_t j : slots) {
+        if (slotRank[j] >= fromRank) slots[kept++] = j;
+    }
+    slots.resize(kept);
+    std::sort(slots.begin(), slots.end(), [this](std::size_t a, std::size_t b) {
+        return slotRank[a] < slotRank[b];
+    });
+}
+
+void Simulation::maybeReorder() {
+    morton.computeKeys(particles, box.width, box.height);
+    if (morton.disorder() <= reorderThreshold) return;
+
+    particles.reorderLive(morton.sortedOrder());
+    if (profile) ++profile->reorders;
+}
+
+void Simulation::handleParticleParticleCollisions(double time) {
+    if (useSpatialGrid) {
+        grid.build(particles, box.width, box.height);
+    }
+    rankByHandle();
+    if (mergeMode == MergeMode::Clusters) {
+        mergeClusters(time);
+        return;
+    }
+
+    std::size_t n = particles.liveCount();
+    const unsigned char* active = particles.active.data();
+    std::uint64_t tests = 0;
+
+    if (!pool && pairsOrdered) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!active[i]) continue;
+            if (useSpatialGrid) resolveMerges(i, time, tests);
+            else                resolveMergesBrute(i, time, tests);
+        }
+        if (profile) profile->pairTests += tests;
+        return;
+    }
+
+    // Con hilos o con la memoria reordenada. Las fusiones van en orden de
+    // rango (handle), y una partícula i solo cambia cuando se fusiona como
+    // 'a' con algún j de rango mayor, que no cambia hasta que le toque.
+    // Entonces si i no toca a ningún j de rango mayor con el estado al
+    // inicio de la fase, nunca se va a fusionar. Detectamos esos candidatos
+    // solo leyendo (en paralelo si hay hilos) y resolvemos las fusiones en
+    // orden creciente de rango, igual que el camino secuencial: el
+    // resultado es idéntico con cualquier cantidad de hilos y cualquier
+    // orden de la memoria.
+    mergeSeeds.assign(n, 0);
+    if (pairsOrdered) {
+        forEachChunk(n, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            std::vector<std::size_t>& scratch = chunkScratch[chunk];
+            std::uint64_t chunkPairTests = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                mergeSeeds[i] = hasOverlap(i, scratch, chunkPairTests) ? 1 : 0;
+            }
+            chunkTests[chunk] += chunkPairTests;
+        });
+    } else {
+        // Cada par que se toca aparece una vez (slot j > i, sin pasar por
+        // los rangos); el candidato es el de menor rango
+        forEachChunk(n, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            std::vector<std::size_t>& scratch = chunkScratch[chunk];
+            std::vector<std::size_t>& pairs = chunkPairs[chunk];
+            std::uint64_t chunkPairTests = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                findOverlaps(i, scratch, pairs, chunkPairTests);
+            }
+            chunkTests[chunk] += chunkPairTests;
+        });
+        for (std::vector<std::size_t>& pairs : chunkPairs) {
+            for (std::size_t k = 0; k < pairs.size(); k += 2) {
+                std::size_t a = pairs[k];
+                std::size_t b = pairs[k + 1];
+                mergeSeeds[slotRank[a] < slotRank[b] ? a : b] = 1;
+            }
+            pairs.clear();
+        }
+    }
+    tests += takeChunkTests();
+
+    for (std::size_t r = 0; r < n; ++r) {
+        std::size_t i = slotAtRank(r);
+        if (!mergeSeeds[i] || !active[i]) continue;
+        if (useSpatialGrid) resolveMerges(i, time, tests);
+        else                resolveMergesBrute(i, time, tests);
+    }
+    if (profile) profile->pairTests += tests;
+}
+
+bool Simulation::hasOverlap(std::size_t i, std::vector<std::size_t>& scratch,
+                            std::uint64_t& tests) const {
+    const ParticleStore& s = particles;
+    std::size_t n = s.liveCount();
+
+    if (!useSpatialGrid) {
         for (std::size_t j = i + 1; j < n; ++j) {
-            Particle& b = particles[j];
-            if (!b.active) continue;
+            ++tests;
+            Vec2 diff = Vec2(s.x[i], s.y[i]) - Vec2(s.x[j], s.y[j]);
+            if (diff.length() <= s.radius[i] + s.radius[j]) return true;
+        }
+        return false;
+    }
 
-            Vec2 diff = a.position - b.position;
+    double reach = s.radius[i] + grid.maxRadius();
+    scratch.clear();
+    grid.query(s.x[i] - reach, s.y[i] - reach, s.x[i] + reach, s.y[i] + reach,
+               i + 1, scratch);
+    for (std::size_t j : scratch) {
+        ++tests;
+        Vec2 diff = Vec2(s.x[i], s.y[i]) - Vec2(s.x[j], s.y[j]);
+        if (diff.length() <= s.radius[i] + s.radius[j]) return true;
+    }
+    return false;
+}
+
+void Simulation::resolveMerges(std::size_t i, double time, std::uint64_t& tests) {
+    double maxR = grid.maxRadius();
+    const unsigned char* active = particles.active.data();
+
+    // Mismo orden que la fuerza bruta: se prueban los j de rango mayor que
+    // i, de menor a mayor. Si hay fusión, 'a' cambia de posición y radio,
+    // así que se vuelve a consultar la grilla desde el siguiente j.
+    std::size_t from = rankOf(i) + 1;
+    bool merged = true;
+    while (merged) {
+        merged = false;
+
+        double ax = particles.x[i];
+        double ay = particles.y[i];
+        double reach = particles.radius[i] + maxR;
+        candidates.clear();
+        grid.query(ax - reach, ay - reach, ax + reach, ay + reach,
+                   pairsOrdered ? from : 0, candidates);
+        if (!pairsOrdered) sortByRank(from, candidates);
+
+        for (std::size_t j : candidates) {
+            if (!active[j]) continue;
+            ++tests;
+
+            Vec2 diff = Vec2(ax, ay) - Vec2(particles.x[j], particles.y[j]);
             double dist = diff.length();
-            double minDist = a.radius + b.radius;
+            double minDist = particles.radius[i] + particles.radius[j];
 
             if (dist <= minDist) {
-                // Colisión completamente inelástica: se fusionan
-                double M = a.mass + b.mass;
+                mergeParticles(i, j, time);
+                from = rankOf(j) + 1;
+                merged = true;
+                break;
+            }
+        }
+    }
+}
+
+void Simulation::resolveMergesBrute(std::size_t i, double time, std::uint64_t& tests) {
+    std::size_t n = particles.liveCount();
+    const unsigned char* active = particles.active.data();
+
+    for (std::size_t r = rankOf(i) + 1; r < n; ++r) {
+        std::size_t j = slotAtRank(r);
+        if (!active[j]) continue;
+        ++tests;
+
+        Vec2 diff = Vec2(particles.x[i], particles.y[i]) -
+                    Vec2(particles.x[j], particles.y[j]);
+        double dist = diff.length();
+        double minDist = particles.radius[i] + particles.radius[j];
+
+        if (dist <= minDist) {
+            mergeParticles(i, j, time);
+        }
+    }
+}
 
-                Vec2 newVel = (a.velocity * a.mass + b.velocity * b.mass) * (1.0 / M);
-                Vec2 newPos = (a.position * a.mass + b.position * b.mass) * (1.0 / M);
+void Simulation::mergeParticles(std::size_t a, std::size_t b, double time) {
+    ParticleStore& s = particles;
 
-                double newRadius = std::sqrt(a.radius * a.radius +
-                                             b.radius * b.radius);
+    // Colisión completamente inelástica: se fusionan
+    double M = s.mass[a] + s.mass[b];
 
-                a.mass = M;
-                a.velocity = newVel;
-                a.position = newPos;
-                a.radius = newRadius;
+    Vec2 va(s.vx[a], s.vy[a]), vb(s.vx[b], s.vy[b]);
+    Vec2 pa(s.x[a], s.y[a]),   pb(s.x[b], s.y[b]);
+    Vec2 newVel = (va * s.mass[a] + vb * s.mass[b]) * (1.0 / M);
+    Vec2 newPos = (pa * s.mass[a] + pb * s.mass[b]) * (1.0 / M);
 
-                b.active = false;
+    double newRadius = std::sqrt(s.radius[a] * s.radius[a] +
+                                 s.radius[b] * s.radius[b]);
 
-                log << "COLLISION_PP " << time << " "
-                    << a.id << " " << b.id
-                    << " MERGE_INTO " << a.id << "\n";
+    s.mass[a] = M;
+    s.vx[a] = newVel.x;
+    s.vy[a] = newVel.y;
+    s.x[a] = newPos.x;
+    s.y[a] = newPos.y;
+    s.radius[a] = newRadius;
+
+    // Queda marcada; compact() la saca del rango vivo al final de la fase
+    s.kill(b);
+
+    events.push_back({time, CollisionKind::Merge, s.id[a], s.id[b], s.id[a]});
+}
+
+void Simulation::findOverlaps(std::size_t i, std::vector<std::size_t>& scratch,
+                              std::vector<std::size_t>& pairs,
+                              std::uint64_t& tests) const {
+    const ParticleStore& s = particles;
+    std::size_t n = s.liveCount();
+
+    if (!useSpatialGrid) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            ++tests;
+            Vec2 diff = Vec2(s.x[i], s.y[i]) - Vec2(s.x[j], s.y[j]);
+            if (diff.length() <= s.radius[i] + s.radius[j]) {
+                pairs.push_back(i);
+                pairs.push_back(j);
             }
         }
+        return;
+    }
+
+    double reach = s.radius[i] + grid.maxRadius();
+    scratch.clear();
+    grid.query(s.x[i] - reach, s.y[i] - reach, s.x[i] + reach, s.y[i] + reach,
+               i + 1, scratch);
+    for (std::size_t j : scratch) {
+        ++tests;
+        Vec2 diff = Vec2(s.x[i], s.y[i]) - Vec2(s.x[j], s.y[j]);
+        if (diff.length() <= s.radius[i] + s.radius[j]) {
+            pairs.push_back(i);
+            pairs.push_back(j);
+        }
     }
 }
 
-void Simulation::logState(std::ofstream& log, double time) {
-    for (const auto& p : particles) {
-        log << "STATE " << time << " "
-            << p.id << " "
-            << p.position.x << " "
-            << p.position.y << " "
-            << p.velocity.x << " "
-            << p.velocity.y << " "
-            << p.mass << " "
-            << p.radius << " "
-            << (p.active ? 1 : 0) << "\n";
+void Simulation::mergeClusters(double time) {
+    ParticleStore& s = particles;
+    std::size_t n = s.liveCount();
+
+    // 1. Pares que se tocan con el estado al inicio de la fase. Es solo
+    //    lectura, así que los bloques corren en paralelo sin problema.
+    forEachChunk(n, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        std::vector<std::size_t>& scratch = chunkScratch[chunk];
+        std::vector<std::size_t>& pairs = chunkPairs[chunk];
+        std::uint64_t tests = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            findOverlaps(i, scratch, pairs, tests);
+        }
+        chunkTests[chunk] += tests;
+    });
+    std::uint64_t tests = takeChunkTests();
+    if (profile) profile->pairTests += tests;
+
+    // 2. Componentes conexas sobre los rangos. La raíz es el rango más
+    //    chico del grupo (el primero en orden de inserción), sin importar en
+    //    qué orden se unan los pares ni cómo esté el almacenamiento.
+    clusters.reset(n);
+    bool anyPair = false;
+    for (std::vector<std::size_t>& pairs : chunkPairs) {
+        for (std::size_t k = 0; k < pairs.size(); k += 2) {
+            clusters.unite(rankOf(pairs[k]), rankOf(pairs[k + 1]));
+        }
+        anyPair = anyPair || !pairs.empty();
+        pairs.clear();
+    }
+    if (!anyPair) return;
+
+    // 3. Miembros de cada grupo (rangos, en orden):
+    //    clusterMembers[clusterStart[r] .. clusterStart[r+1])
+    clusterStart.assign(n + 1, 0);
+    for (std::size_t r = 0; r < n; ++r) {
+        ++clusterStart[clusters.find(r) + 1];
+    }
+    for (std::size_t r = 0; r < n; ++r) {
+        clusterStart[r + 1] += clusterStart[r];
+    }
+    clusterMembers.resize(n);
+    std::vector<std::size_t>& fill = chunkScratch[0];
+    fill.assign(clusterStart.begin(), clusterStart.end() - 1);
+    for (std::size_t r = 0; r < n; ++r) {
+        clusterMembers[fill[clusters.find(r)]++] = r;
+    }
+
+    // 4. Cada grupo se vuelve una sola partícula en su raíz: se conservan
+    //    masa y momento, y el área (r^2 = suma de r_k^2) como en
+    //    mergeParticles. Los eventos de un grupo van juntos, por raíz.
+    for (std::size_t r = 0; r < n; ++r) {
+        std::size_t begin = clusterStart[r];
+        std::size_t end = clusterStart[r + 1];
+        if (end - begin < 2) continue;
+        std::size_t root = slotAtRank(r);
+
+        double M = 0.0;
+        double r2 = 0.0;
+        Vec2 momentum, moment;
+        for (std::size_t k = begin; k < end; ++k) {
+            std::size_t m = slotAtRank(clusterMembers[k]);
+            M += s.mass[m];
+            r2 += s.radius[m] * s.radius[m];
+            momentum += Vec2(s.vx[m], s.vy[m]) * s.mass[m];
+            moment += Vec2(s.x[m], s.y[m]) * s.mass[m];
+        }
+        Vec2 newVel = momentum * (1.0 / M);
+        Vec2 newPos = moment * (1.0 / M);
+
+        s.mass[root] = M;
+        s.vx[root] = newVel.x;
+        s.vy[root] = newVel.y;
+        s.x[root] = newPos.x;
+        s.y[root] = newPos.y;
+        s.radius[root] = std::sqrt(r2);
+
+        for (std::size_t k = begin + 1; k < end; ++k) {
+            std::size_t m = slotAtRank(clusterMembers[k]);
+            s.kill(m);
+            events.push_back({time, CollisionKind::Merge, s.id[root], s.id[m], s.id[root]});
+        }
     }
-    log << "\n";
 }
@@ -3,18 +3,76 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 #include "Box.h"
 #include "Particle.h"
+#include "ParticleStore.h"
 #include "Obstacle.h"
+#include "SpatialGrid.h"
+#include "ObstacleIndex.h"
+#include "CollisionEvent.h"
+#include "TrajectoryWriter.h"
+#include "PhaseProfile.h"
+#include "UnionFind.h"
+#include "MortonOrder.h"
+
+class ThreadPool;
+class EventSink;
+
+enum class SimulationEngine {
+    FixedStep,   // paso fijo dt (por defecto)
+    EventDriven  // tiempos de impacto exactos, ver EventDrivenEngine
+};
+
+// Cómo se resuelven las fusiones de un paso (solo paso fijo)
+enum class MergeMode {
+    Sequential,  // en orden de slot, una por una (por defecto)
+    Clusters     // cada grupo de partículas que se tocan, de una vez
+};
 
 class Simulation {
 public:
     Box box;
-    std::vector<Particle> particles;
+    ParticleStore particles;
     std::vector<Obstacle> obstacles;
     double dt;
     double totalTime;
     double obstacleRestitution; // e
+    bool useSpatialGrid;        // false = fuerza bruta O(n^2), para verificar
+    bool useObstacleIndex;      // false = probar todos los obstáculos
+    OutputFormat outputFormat;  // texto (por defecto), binario o delta
+    int keyframeEvery;          // con OutputFormat::Delta: paso completo cada K
+    bool textIndex;             // con OutputFormat::Text: índice <salida>.idx
+    bool asyncOutput;           // escribir la salida en un hilo aparte
+    unsigned numThreads;        // 1 = todo secuencial
+    SimulationEngine engine;
+    MergeMode mergeMode;
+
+    // Reordenamiento de la memoria según una curva Z (solo paso fijo, ver
+    // MortonOrder.h). Cada reorderEvery pasos se mide el desorden y, si
+    // supera reorderThreshold, se reordenan las partículas vivas. 0 = nunca.
+    // La salida no cambia: el log, los eventos y las fusiones siguen el
+    // orden de inserción, no el de los slots.
+    int reorderEvery;
+    double reorderThreshold;
+    bool verbose;               // avisar por consola al terminar
+
+    // Paso adaptivo (solo paso fijo). dt pasa a ser el intervalo de
+    // registro: cada intervalo se parte en subpasos iguales de modo que
+    // ninguna partícula avance más de stepSafety veces el menor radio vivo
+    // o el menor obstáculo, con el subpaso entre minDt y maxDt (y nunca
+    // mayor que dt).
+    bool adaptiveStep;
+    double minDt;
+    double maxDt;
+    double stepSafety;
+    PhaseProfile* profile;      // tiempos y contadores; nullptr = no medir
+    EventSink* eventSink;       // recibe las colisiones de cada paso; nullptr = nadie
+
+    // Puntos de control (solo paso fijo, ver Checkpoint.h)
+    int startStep;              // primer paso a ejecutar (> 0 al reanudar)
+    int checkpointEvery;        // cada cuántos pasos guardar; 0 = nunca
+    std::string checkpointFile; // se sobrescribe con el último
 
     Simulation(double width, double height,
                double dt_, double totalTime_,
@@ -23,12 +81,91 @@ public:
     void addParticle(const Particle& p);
     void addObstacle(const Obstacle& o);
 
-    void run(const std::string& outputFile);
+    // Devuelve false si no se pudo abrir la salida o guardar un punto de control
+    bool run(const std::string& outputFile);
+
+    // Registra un paso: el frame para la salida (si escribe algo) y las
+    // colisiones para eventSink. También lo usa EventDrivenEngine.
+    void recordStep(TrajectoryWriter& log, double time,
+                    const std::vector<CollisionEvent>& stepEvents);
 
 private:
-    void handleParticleObstacleCollisions(std::ofstream& log, double time);
-    void handleParticleParticleCollisions(std::ofstream& log, double time);
-    void logState(std::ofstream& log, double time);
+    // false si no se pudo guardar algún punto de control
+    bool runFixedStep(TrajectoryWriter& log);
+
+    // Corre f(begin, end, chunk) sobre [0, n): en el pool si hay, si no en
+    // un solo bloque. Los eventos de cada bloque van a chunkEvents[chunk].
+    template <typename F>
+    void forEachChunk(std::size_t n, F&& f);
+    void appendChunkEvents();
+    // Suma y vuelve a cero los contadores de pruebas de cada bloque
+    std::uint64_t takeChunkTests();
+
+    // Un paso de física de largo h que empieza en 'time'
+    void advance(double time, double h);
+    int substepsFor(double interval) const;
+
+    void integratePositions(double h);
+    void handleWallCollisions(double time);
+    void handleParticleObstacleCollisions(double time);
+    void bounceOffObstacle(std::size_t i, std::size_t j, const Vec2& normal,
+                           double time, std::vector<CollisionEvent>& out);
+    void handleParticleParticleCollisions(double time);
+    // 'tests' acumula cuántas distancias entre pares se calcularon
+    void resolveMerges(std::size_t i, double time, std::uint64_t& tests);
+    void resolveMergesBrute(std::size_t i, double time, std::uint64_t& tests);
+    bool hasOverlap(std::size_t i, std::vector<std::size_t>& scratch,
+                    std::uint64_t& tests) const;
+    void mergeParticles(std::size_t a, std::size_t b, double time);
+    // MergeMode::Clusters: busca todos los pares que se tocan al inicio de
+    // la fase y fusiona cada componente conexa en su slot más chico
+    void mergeClusters(double time);
+    void findOverlaps(std::size_t i, std::vector<std::size_t>& scratch,
+                      std::vector<std::size_t>& pairs, std::uint64_t& tests) const;
+
+    void maybeReorder();
+    // Deja en orden de handle los eventos [first, end) si el almacenamiento
+    // está reordenado
+    void sortEventsByHandle(std::size_t first);
+
+    // La fase de pares recorre las partículas por "rango" (posición en
+    // orden de handle entre las vivas). Si el almacenamiento está en orden
+    // de inserción, rango == slot y no se arma nada.
+    void rankByHandle();
+    std::size_t slotAtRank(std::size_t r) const { return pairsOrdered ? r : rankSlot[r]; }
+    std::size_t rankOf(std::size_t slot) const { return pairsOrdered ? slot : slotRank[slot]; }
+    // Deja los slots de rango >= fromRank, ordenados por rango
+    void sortByRank(std::size_t fromRank, std::vector<std::size_t>& slots) const;
+
+    // Colisiones del paso actual, en el orden en que ocurrieron
+    std::vector<CollisionEvent> events;
+
+    SpatialGrid grid;
+    ObstacleIndex obstacleIndex;
+    std::vector<std::size_t> candidates;
+
+    // Estado del modo paralelo (solo válido dentro de run())
+    ThreadPool* pool;
+    std::size_t numChunks;
+    std::vector<std::vector<CollisionEvent>> chunkEvents;
+    std::vector<WallHits> chunkWallHits;
+    std::vector<std::vector<std::size_t>> chunkScratch;
+    std::vector<std::uint64_t> chunkTests;
+    std::vector<unsigned char> mergeSeeds;
+
+    // Estado de MergeMode::Clusters. chunkPairs[c] guarda los pares (i, j)
+    // de cada bloque como i, j consecutivos.
+    std::vector<std::vector<std::size_t>> chunkPairs;
+    UnionFind clusters;
+    std::vector<std::size_t> clusterStart;
+    std::vector<std::size_t> clusterMembers;
+
+    MortonOrder morton;
+    bool pairsOrdered;
+    std::vector<std::size_t> rankSlot;  // rango -> slot
+    std::vector<std::size_t> slotRank;  // slot -> rango
+    std::vector<std::pair<std::size_t, std::size_t>> eventKeys;
+    std::vector<CollisionEvent> eventScratch;
 };
 
 #endif // SIMULATION_H
@@ -0,0 +1,86 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid()
+    : cellSize(1.0), invCellSize(1.0), cols(1), rows(1), maxR(0.0)
+{
+}
+
+int SpatialGrid::cellCoord(double v, int n) const {
+    int c = static_cast<int>(std::floor(v * invCellSize));
+    if (c < 0) c = 0;
+    if (c >= n) c = n - 1;
+    return c;
+}
+
+void SpatialGrid::build(const ParticleStore& particles,
+                        double width, double height) {
+    std::size_t n = particles.liveCount();
+    const Scalar* px = particles.x.data();
+    const Scalar* py = particles.y.data();
+    const Scalar* pr = particles.radius.data();
+
+    maxR = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        maxR = std::max<double>(maxR, pr[i]);
+    }
+
+    // Dos partículas que se tocan están a lo sumo a 2*maxR, así que con ese
+    // lado basta revisar las celdas vecinas.
+    cellSize = 2.0 * maxR;
+    if (cellSize <= 0.0) cellSize = std::max(width, height);
+
+    // Limitamos la cantidad de celdas para que una caja enorme con radios
+    // pequeños no se coma la memoria
+    double maxCells = 4.0 * static_cast<double>(n) + 16.0;
+    if ((width / cellSize) * (height / cellSize) > maxCells) {
+        cellSize = std::sqrt(width * height / maxCells);
+    }
+    invCellSize = 1.0 / cellSize;
+    cols = std::max(1, static_cast<int>(std::ceil(width * invCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height * invCellSize)));
+
+    std::size_t numCells = static_cast<std::size_t>(cols) * rows;
+    cellStart.assign(numCells + 1, 0);
+    cellOf.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        int c = cellCoord(py[i], rows) * cols + cellCoord(px[i], cols);
+        cellOf[i] = c;
+        ++cellStart[c + 1];
+    }
+
+    for (std::size_t c = 0; c < numCells; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    // Al recorrer en orden cada celda queda ordenada por índice
+    entries.resize(cellStart[numCells]);
+    fill.assign(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        entries[fill[cellOf[i]]++] = i;
+    }
+}
+
+void SpatialGrid::query(double minX, double minY, double maxX, double maxY,
+                        std::size_t fromIndex, std::vector<std::size_t>& out) const {
+    int cx0 = cellCoord(minX, cols);
+    int cx1 = cellCoord(maxX, cols);
+    int cy0 = cellCoord(minY, rows);
+    int cy1 = cellCoord(maxY, rows);
+
+    std::size_t first = out.size();
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            std::size_t c = static_cast<std::size_t>(cy) * cols + cx;
+            auto begin = entries.begin() + cellStart[c];
+            auto end   = entries.begin() + cellStart[c + 1];
+            // Cada celda está ordenada: saltamos directo a los índices >= fromIndex
+            for (auto it = std::lower_bound(begin, end, fromIndex); it != end; ++it) {
+                out.push_back(*it);
+            }
+        }
+    }
+    std::sort(out.begin() + first, out.end());
+}
@@ -0,0 +1,46 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <vector>
+#include <cstddef>
+#include "ParticleStore.h"
+
+// Grilla uniforme para la fase "broad phase" de colisiones partícula-partícula.
+// Cada partícula viva (slots [0, liveCount())) se guarda en la celda que contiene su centro; el tamaño
+// de celda sale del radio máximo, así que si las fusiones agrandan los radios
+// la grilla se vuelve a dimensionar en el siguiente build().
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    // Reconstruye la grilla sobre la caja [0,width] x [0,height]
+    void build(const ParticleStore& particles,
+               double width, double height);
+
+    // Agrega a 'out' los slots (>= fromIndex) de las partículas cuyo centro
+    // cae en alguna celda que toca el rectángulo [minX,maxX] x [minY,maxY].
+    // El resultado queda ordenado por slot.
+    void query(double minX, double minY, double maxX, double maxY,
+               std::size_t fromIndex, std::vector<std::size_t>& out) const;
+
+    // Radio máximo entre las partículas activas al momento del build()
+    double maxRadius() const { return maxR; }
+
+private:
+    double cellSize;
+    double invCellSize;
+    int cols;
+    int rows;
+    double maxR;
+
+    // Ordenamiento por conteo: las partículas de la celda c están en
+    // entries[cellStart[c] .. cellStart[c+1])
+    std::vector<std::size_t> cellStart;
+    std::vector<std::size_t> entries;
+    std::vector<int> cellOf;
+    std::vector<std::size_t> fill;   // auxiliar de build(), se reutiliza
+
+    int cellCoord(double v, int n) const;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,84 @@
+#include "TaskPool.h"
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+TaskPool::TaskPool(unsigned numThreads_)
+    : numThreads(numThreads_ > 0 ? numThreads_ : 1),
+    queues(numThreads),
+    tasks(nullptr),
+    cost(nullptr)
+{
+}
+
+bool TaskPool::popOwn(std::size_t self, std::size_t& task) {
+    Queue& q = queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.items.empty()) return false;
+    task = q.items.front();
+    q.items.pop_front();
+    return true;
+}
+
+bool TaskPool::steal(std::size_t self, std::size_t& task) {
+    // La víctima es la cola cuya próxima tarea es la más larga. Las colas
+    // se miran de a una; si otro hilo se la lleva antes, se vuelve a buscar.
+    for (;;) {
+        std::size_t victim = queues.size();
+        double best = -1.0;
+        for (std::size_t q = 0; q < queues.size(); ++q) {
+            if (q == self) continue;
+            std::lock_guard<std::mutex> lock(queues[q].mutex);
+            if (!queues[q].items.empty() && (*cost)[queues[q].items.front()] > best) {
+                best = (*cost)[queues[q].items.front()];
+                victim = q;
+            }
+        }
+        if (victim == queues.size()) return false;
+
+        Queue& q = queues[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.items.empty()) continue;
+        task = q.items.front();
+        q.items.pop_front();
+        return true;
+    }
+}
+
+void TaskPool::workerLoop(std::size_t self) {
+    std::size_t task;
+    // Las tareas no generan tareas nuevas: cuando no queda nada para robar
+    // el hilo termina
+    while (popOwn(self, task) || steal(self, task)) {
+        (*tasks)[task]();
+    }
+}
+
+void TaskPool::run(const std::vector<Task>& tasks_, const std::vector<double>& cost_) {
+    tasks = &tasks_;
+    cost = &cost_;
+
+    std::vector<std::size_t> order(tasks_.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return cost_[a] > cost_[b];
+    });
+
+    // Reparto en ronda: cada cola queda ordenada de mayor a menor y con una
+    // carga parecida a las demás
+    for (std::size_t k = 0; k < order.size(); ++k) {
+        queues[k % numThreads].items.push_back(order[k]);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; ++t) {
+        workers.emplace_back(&TaskPool::workerLoop, this, static_cast<std::size_t>(t));
+    }
+    workerLoop(0);
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    tasks = nullptr;
+    cost = nullptr;
+}
@@ -0,0 +1,51 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Pool con robo de trabajo para tareas largas e independientes (corridas
+// enteras de un ensamble). A diferencia de ThreadPool, las tareas no son
+// bloques de un mismo rango sino trabajos de duración muy distinta.
+//
+// Las tareas se ordenan de mayor a menor costo estimado y se reparten en
+// una cola por hilo. Cada hilo toma de la suya la más larga que le queda;
+// cuando se vacía, le roba a otro la más larga que haya. Así las corridas
+// largas arrancan primero y al final solo quedan tareas cortas para
+// emparejar, sin núcleos ociosos esperando a una rezagada.
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    // El hilo que llama a run() también trabaja: N hilos crean N-1 más
+    explicit TaskPool(unsigned numThreads);
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    unsigned size() const { return numThreads; }
+
+    // Ejecuta todas las tareas y vuelve cuando terminaron. cost[i] es una
+    // estimación relativa de la duración de tasks[i].
+    void run(const std::vector<Task>& tasks, const std::vector<double>& cost);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> items; // índices, de mayor a menor costo
+    };
+
+    unsigned numThreads;
+    std::vector<Queue> queues;
+    const std::vector<Task>* tasks;
+    const std::vector<double>* cost;
+
+    void workerLoop(std::size_t self);
+    bool popOwn(std::size_t self, std::size_t& task);
+    bool steal(std::size_t self, std::size_t& task);
+};
+
+#endif // TASKPOOL_H
@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned numThreads)
+    : stopping(false),
+    generation(0),
+    job(nullptr),
+    jobSize(0),
+    jobChunks(0),
+    nextChunk(0),
+    chunksLeft(0),
+    busyWorkers(0)
+{
+    for (unsigned t = 1; t < numThreads; ++t) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+std::size_t ThreadPool::runChunks(const RangeFn& f, std::size_t n,
+                                  std::size_t numChunks) {
+    std::size_t finished = 0;
+    for (;;) {
+        std::size_t c = nextChunk.fetch_add(1);
+        if (c >= numChunks) break;
+        std::size_t begin = n * c / numChunks;
+        std::size_t end   = n * (c + 1) / numChunks;
+        f(begin, end, c);
+        ++finished;
+    }
+    return finished;
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long seen = 0;
+    for (;;) {
+        // El trabajo se copia con el lock tomado: el próximo parallelFor()
+        // puede reescribir los campos apenas este termine
+        const RangeFn* f = nullptr;
+        std::size_t n = 0;
+        std::size_t numChunks = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            // Despertó tarde: ese parallelFor() ya volvió
+            if (job == nullptr) continue;
+            f = job;
+            n = jobSize;
+            numChunks = jobChunks;
+            ++busyWorkers;
+        }
+
+        std::size_t finished = runChunks(*f, n, numChunks);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunksLeft -= finished;
+            --busyWorkers;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t n, std::size_t numChunks, const RangeFn& f) {
+    if (n == 0) return;
+    if (numChunks < 1) numChunks = 1;
+    if (numChunks > n) numChunks = n;
+
+    if (workers.empty() || numChunks == 1) {
+        for (std::size_t c = 0; c < numChunks; ++c) {
+            f(n * c / numChunks, n * (c + 1) / numChunks, c);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &f;
+        jobSize = n;
+        jobChunks = numChunks;
+        chunksLeft = numChunks;
+        nextChunk.store(0);
+        ++generation;
+    }
+    wake.notify_all();
+
+    std::size_t finished = runChunks(f, n, numChunks);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    chunksLeft -= finished;
+    done.wait(lock, [this] { return chunksLeft == 0 && busyWorkers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos fijo para repartir un rango entre núcleos. El hilo que
+// llama a parallelFor() también trabaja, así que un pool de N hilos crea
+// N-1 hilos auxiliares.
+class ThreadPool {
+public:
+    using RangeFn = std::function<void(std::size_t begin, std::size_t end,
+                                       std::size_t chunk)>;
+
+    explicit ThreadPool(unsigned numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Divide [0, n) en 'numChunks' bloques contiguos y llama f(begin, end,
+    // chunk) una vez por bloque. Los bloques se numeran en orden, así que
+    // juntar resultados por número de bloque da el mismo orden que un
+    // recorrido secuencial, sin importar cuántos hilos haya.
+    void parallelFor(std::size_t n, std::size_t numChunks, const RangeFn& f);
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping;
+    unsigned long generation;
+
+    const RangeFn* job;
+    std::size_t jobSize;
+    std::size_t jobChunks;
+    std::atomic<std::size_t> nextChunk;
+    std::size_t chunksLeft;
+    unsigned busyWorkers; // hilos dentro de runChunks(); el siguiente
+                          // trabajo espera a que salgan todos
+
+    void workerLoop();
+    std::size_t runChunks(const RangeFn& f, std::size_t n, std::size_t numChunks);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,140 @@
+#ifndef TRAJECTORYFORMAT_H
+#define TRAJECTORYFORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Formato binario de trayectorias (little endian).
+//
+//   FileHeader
+//   por cada paso:
+//       StepHeader
+//       columnas de largo count, en este orden:
+//           x, y, vx, vy, mass, radius   (double)
+//           id                           (int32)
+//           active                       (uint8)
+//       relleno hasta múltiplo de 8
+//       sección de colisiones: eventCount * CollisionEvent
+//   índice: numSteps * uint64 (offset de cada StepHeader)
+//   FileFooter
+//
+// Todo bloque empieza alineado a 8 bytes, así que un lector que mapea el
+// archivo puede apuntar directo a las columnas sin copiar. Si el archivo
+// quedó cortado (sin índice ni footer) se puede recorrer paso por paso.
+//
+// Modo delta (FileHeader::flags & kFlagDelta): cada tantos pasos hay un
+// paso completo como el de arriba (keyframe, tag kStepTag). Los demás
+// llevan tag kDeltaTag y en lugar de las columnas traen count * DeltaRecord:
+// solo las filas que no se pueden deducir del paso anterior. Una fila se
+// deduce si su velocidad, masa, radio y estado no cambiaron y su posición es
+// predictPosition() de la anterior. Las filas siguen el orden de inserción
+// y la cantidad no cambia entre pasos.
+namespace trajectory {
+
+const char kMagic[8]       = {'P', '5', 'T', 'R', 'A', 'J', '\0', '\0'};
+const char kFooterMagic[8] = {'P', '5', 'I', 'N', 'D', 'E', 'X', '\0'};
+const std::uint32_t kVersion = 1;
+const std::uint32_t kStepTag = 0x50455453;  // "STEP"
+const std::uint32_t kDeltaTag = 0x544c4544; // "DELT"
+
+const std::uint32_t kFlagDelta = 1;
+const std::uint32_t kFlagFloatState = 2; // la simulación corrió en float
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t numParticles;
+    double dt;
+    double totalTime;
+    double width;
+    double height;
+};
+
+struct StepHeader {
+    std::uint32_t tag;
+    std::uint32_t reserved;
+    double time;
+    std::uint64_t count;       // filas de las columnas
+    std::uint64_t eventCount;  // registros de colisión del paso
+};
+
+struct FileFooter {
+    std::uint64_t indexOffset;
+    std::uint64_t numSteps;
+    char magic[8];
+};
+
+// Fila que cambió en un paso delta
+struct DeltaRecord {
+    std::uint32_t row;
+    std::uint8_t active;
+    std::uint8_t padding[3];
+    double x, y, vx, vy, mass, radius;
+};
+
+static_assert(sizeof(DeltaRecord) == 56, "DeltaRecord debe medir 56 bytes");
+static_assert(sizeof(FileHeader) == 56, "FileHeader debe medir 56 bytes");
+static_assert(sizeof(StepHeader) == 32, "StepHeader debe medir 32 bytes");
+static_assert(sizeof(FileFooter) == 24, "FileFooter debe medir 24 bytes");
+
+inline std::uint64_t padTo8(std::uint64_t n) {
+    return (n + 7) & ~static_cast<std::uint64_t>(7);
+}
+
+// Bytes de las columnas de un paso con 'count' filas (ya con relleno)
+inline std::uint64_t columnBytes(std::uint64_t count) {
+    return padTo8(count * (6 * sizeof(double) + sizeof(std::int32_t) + 1));
+}
+
+// Bytes del cuerpo de un paso (sin StepHeader ni colisiones)
+inline std::uint64_t bodyBytes(std::uint32_t tag, std::uint64_t count) {
+    return tag == kDeltaTag ? count * sizeof(DeltaRecord) : columnBytes(count);
+}
+
+// Índice del log de texto (archivo aparte, <log>.idx, ver
+// Simulation::textIndex): TextIndexHeader y numSteps * TextIndexEntry. Cada
+// paso del log es un bloque de líneas COLLISION* seguidas de líneas STATE y
+// una línea vacía; la entrada guarda dónde empieza cada parte.
+const char kTextIndexMagic[8] = {'P', '5', 'T', 'X', 'I', 'D', 'X', '\0'};
+const std::uint32_t kTextIndexVersion = 1;
+
+struct TextIndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t numSteps;
+    std::uint64_t numParticles;
+    std::uint64_t logBytes;    // tamaño del log indexado, para notar si cambió
+    double dt;
+    double totalTime;
+};
+
+struct TextIndexEntry {
+    double time;
+    std::uint64_t offset;       // primer byte del bloque (primera colisión)
+    std::uint64_t stateOffset;  // primera línea STATE
+    std::uint64_t endOffset;    // después de la línea vacía final
+    std::uint64_t firstEvent;   // colisiones de pasos anteriores
+    std::uint64_t eventCount;
+};
+
+static_assert(sizeof(TextIndexHeader) == 56, "TextIndexHeader debe medir 56 bytes");
+static_assert(sizeof(TextIndexEntry) == 48, "TextIndexEntry debe medir 48 bytes");
+
+// Posición de una fila en el paso siguiente si nada la cambió, con la misma
+// aritmética que la simulación: en T = Scalar del programa que escribió el
+// archivo (float si FileHeader::flags tiene kFlagFloatState). El producto
+// pasa por una variable volatile para que el compilador no lo junte con la
+// suma en una FMA: escritor y lector tienen que dar el mismo resultado bit
+// a bit aunque se compilen con opciones distintas.
+template <typename T>
+inline double predictPosition(double x, double v, double dt, bool active) {
+    if (!active) return x;
+    volatile T displacement = static_cast<T>(v) * static_cast<T>(dt);
+    return static_cast<T>(x) + displacement;
+}
+
+} // namespace trajectory
+
+#endif // TRAJECTORYFORMAT_H
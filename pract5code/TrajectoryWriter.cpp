@@ -0,0 +1,327 @@
+#include "TrajectoryWriter.h"
+#include "TrajectoryFormat.h"
+#include "Box.h"
+#include "ParticleStore.h"
+#include <cstring>
+#include <iostream>
+
+void StepFrame::capture(double t, const ParticleStore& s,
+                        const std::vector<CollisionEvent>& stepEvents) {
+    time = t;
+    events.assign(stepEvents.begin(), stepEvents.end());
+
+    std::size_t n = s.size();
+    id.resize(n);
+    x.resize(n);
+    y.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    mass.resize(n);
+    radius.resize(n);
+    active.resize(n);
+
+    std::size_t row = 0;
+    s.forEachInOrder([&](std::size_t slot) {
+        id[row] = s.id[slot];
+        x[row] = s.x[slot];
+        y[row] = s.y[slot];
+        vx[row] = s.vx[slot];
+        vy[row] = s.vy[slot];
+        mass[row] = s.mass[slot];
+        radius[row] = s.radius[slot];
+        active[row] = s.active[slot];
+        ++row;
+    });
+}
+
+std::unique_ptr<TrajectoryWriter> TrajectoryWriter::create(OutputFormat format,
+                                                           int keyframeEvery,
+                                                           bool textIndex) {
+    if (format == OutputFormat::Delta) {
+        return std::unique_ptr<TrajectoryWriter>(new DeltaTrajectoryWriter(keyframeEvery));
+    }
+    if (format == OutputFormat::None) {
+        return std::unique_ptr<TrajectoryWriter>(new NullTrajectoryWriter());
+    }
+    if (format == OutputFormat::Binary) {
+        return std::unique_ptr<TrajectoryWriter>(new BinaryTrajectoryWriter());
+    }
+    return std::unique_ptr<TrajectoryWriter>(new TextTrajectoryWriter(textIndex));
+}
+
+// ---------------------------------------------------------------- texto
+
+TextTrajectoryWriter::TextTrajectoryWriter(bool writeIndex_)
+    : writeIndex(writeIndex_)
+{
+    std::memset(&indexHeader, 0, sizeof(indexHeader));
+}
+
+bool TextTrajectoryWriter::open(const std::string& path) {
+    // Binario para que los offsets del índice sean bytes reales también en
+    // Windows (sin traducir \n a \r\n)
+    log.open(path, writeIndex ? std::ios::out | std::ios::binary : std::ios::out);
+    written = 0;
+    indexPath = indexPathFor(path);
+    index.clear();
+    return static_cast<bool>(log);
+}
+
+void TextTrajectoryWriter::writeHeader(std::size_t numParticles, double dt,
+                                       double totalTime, const Box&) {
+    log << "# numParticles dt totalTime\n";
+    log << numParticles << " " << dt << " " << totalTime << "\n\n";
+
+    std::memcpy(indexHeader.magic, trajectory::kTextIndexMagic, sizeof(indexHeader.magic));
+    indexHeader.version = trajectory::kTextIndexVersion;
+    indexHeader.numParticles = numParticles;
+    indexHeader.dt = dt;
+    indexHeader.totalTime = totalTime;
+}
+
+void TextTrajectoryWriter::writeEvent(std::ostream& out, const CollisionEvent& e) {
+    switch (e.kind) {
+    case CollisionKind::WallLeft:
+        out << "COLLISION " << e.time << " " << e.particle << " MURO_IZQ";
+        break;
+    case CollisionKind::WallRight:
+        out << "COLLISION " << e.time << " " << e.particle << " MURO_DER";
+        break;
+    case CollisionKind::WallBottom:
+        out << "COLLISION " << e.time << " " << e.particle << " MURO_ABAJ";
+        break;
+    case CollisionKind::WallTop:
+        out << "COLLISION " << e.time << " " << e.particle << " MURO_ARR";
+        break;
+    case CollisionKind::Obstacle:
+        out << "COLLISION_PO " << e.time << " " << e.particle
+            << " OBSTACLE " << e.other;
+        break;
+    case CollisionKind::Merge:
+        out << "COLLISION_PP " << e.time << " "
+            << e.particle << " " << e.other
+            << " MERGE_INTO " << e.into;
+        break;
+    }
+}
+
+void TextTrajectoryWriter::writeStep(const StepFrame& f) {
+    trajectory::TextIndexEntry entry;
+    if (writeIndex) {
+        entry.time = f.time;
+        entry.offset = position();
+        entry.firstEvent = index.empty() ? 0 : index.back().firstEvent + index.back().eventCount;
+        entry.eventCount = f.events.size();
+    }
+
+    for (const CollisionEvent& e : f.events) {
+        writeEvent(log, e);
+        log << "\n";
+    }
+    if (writeIndex) entry.stateOffset = position();
+
+    for (std::size_t i = 0; i < f.count(); ++i) {
+        log << "STATE " << f.time << " "
+            << f.id[i] << " "
+            << f.x[i] << " "
+            << f.y[i] << " "
+            << f.vx[i] << " "
+            << f.vy[i] << " "
+            << f.mass[i] << " "
+            << f.radius[i] << " "
+            << (f.active[i] ? 1 : 0) << "\n";
+    }
+    log << "\n";
+
+    if (writeIndex) {
+        entry.endOffset = position();
+        index.push_back(entry);
+    }
+}
+
+void TextTrajectoryWriter::close() {
+    if (!log.is_open()) return;
+    std::streamoff end = log.tellp();
+    written = end > 0 ? static_cast<std::uint64_t>(end) : 0;
+    log.close();
+
+    if (writeIndex && !saveIndex()) {
+        std::cerr << "No se pudo escribir el índice " << indexPath << "\n";
+    }
+}
+
+bool TextTrajectoryWriter::saveIndex() {
+    std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    indexHeader.numSteps = index.size();
+    indexHeader.logBytes = written;
+    out.write(reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader));
+    out.write(reinterpret_cast<const char*>(index.data()),
+              static_cast<std::streamsize>(index.size() * sizeof(trajectory::TextIndexEntry)));
+    return static_cast<bool>(out);
+}
+
+// --------------------------------------------------------------- binario
+
+void BinaryTrajectoryWriter::writeRaw(const void* data, std::size_t bytes) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    offset += bytes;
+}
+
+bool BinaryTrajectoryWriter::open(const std::string& path) {
+    out.open(path, std::ios::binary);
+    offset = 0;
+    stepOffsets.clear();
+    return static_cast<bool>(out);
+}
+
+void BinaryTrajectoryWriter::writeHeader(std::size_t numParticles, double dt,
+                                         double totalTime, const Box& box) {
+    trajectory::FileHeader h;
+    std::memcpy(h.magic, trajectory::kMagic, sizeof(h.magic));
+    h.version = trajectory::kVersion;
+    h.flags = headerFlags;
+    if (sizeof(Scalar) == sizeof(float)) h.flags |= trajectory::kFlagFloatState;
+    h.numParticles = numParticles;
+    h.dt = dt;
+    h.totalTime = totalTime;
+    h.width = box.width;
+    h.height = box.height;
+    writeRaw(&h, sizeof(h));
+    stepDt = dt;
+}
+
+void BinaryTrajectoryWriter::beginStepRecord(std::uint32_t tag, const StepFrame& f,
+                                             std::uint64_t count) {
+    stepOffsets.push_back(offset);
+
+    trajectory::StepHeader h;
+    h.tag = tag;
+    h.reserved = 0;
+    h.time = f.time;
+    h.count = count;
+    h.eventCount = f.events.size();
+    writeRaw(&h, sizeof(h));
+}
+
+void BinaryTrajectoryWriter::writeEvents(const StepFrame& f) {
+    if (!f.events.empty()) {
+        writeRaw(f.events.data(), f.events.size() * sizeof(CollisionEvent));
+    }
+}
+
+void BinaryTrajectoryWriter::writeFullStep(const StepFrame& f) {
+    std::size_t n = f.count();
+
+    beginStepRecord(trajectory::kStepTag, f, n);
+
+    writeRaw(f.x.data(), n * sizeof(double));
+    writeRaw(f.y.data(), n * sizeof(double));
+    writeRaw(f.vx.data(), n * sizeof(double));
+    writeRaw(f.vy.data(), n * sizeof(double));
+    writeRaw(f.mass.data(), n * sizeof(double));
+    writeRaw(f.radius.data(), n * sizeof(double));
+    writeRaw(f.id.data(), n * sizeof(std::int32_t));
+    writeRaw(f.active.data(), n);
+
+    static const char zeros[8] = {0};
+    std::uint64_t used = n * (6 * sizeof(double) + sizeof(std::int32_t) + 1);
+    writeRaw(zeros, trajectory::columnBytes(n) - used);
+
+    writeEvents(f);
+}
+
+void BinaryTrajectoryWriter::writeStep(const StepFrame& f) {
+    writeFullStep(f);
+}
+
+void BinaryTrajectoryWriter::close() {
+    if (!out.is_open()) return;
+
+    trajectory::FileFooter f;
+    f.indexOffset = offset;
+    f.numSteps = stepOffsets.size();
+    std::memcpy(f.magic, trajectory::kFooterMagic, sizeof(f.magic));
+
+    writeRaw(stepOffsets.data(), stepOffsets.size() * sizeof(std::uint64_t));
+    writeRaw(&f, sizeof(f));
+    out.close();
+}
+
+// ------------------------------------------------------------------ delta
+
+namespace {
+
+// Igualdad bit a bit (distingue 0.0 de -0.0)
+inline bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // namespace
+
+DeltaTrajectoryWriter::DeltaTrajectoryWriter(int keyframeEvery_)
+    : keyframeEvery(keyframeEvery_ > 0 ? keyframeEvery_ : 1),
+    sinceKeyframe(0)
+{
+    headerFlags = trajectory::kFlagDelta;
+}
+
+bool DeltaTrajectoryWriter::open(const std::string& path) {
+    sinceKeyframe = 0;
+    return BinaryTrajectoryWriter::open(path);
+}
+
+void DeltaTrajectoryWriter::writeStep(const StepFrame& f) {
+    std::size_t n = f.count();
+
+    if (sinceKeyframe == 0 || n != previous.count()) {
+        writeFullStep(f);
+    } else {
+        records.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            bool wasActive = previous.active[i] != 0;
+            double px = trajectory::predictPosition<Scalar>(previous.x[i], previous.vx[i],
+                                                            stepDt, wasActive);
+            double py = trajectory::predictPosition<Scalar>(previous.y[i], previous.vy[i],
+                                                            stepDt, wasActive);
+            if (f.active[i] == previous.active[i] &&
+                sameBits(f.x[i], px) && sameBits(f.y[i], py) &&
+                sameBits(f.vx[i], previous.vx[i]) && sameBits(f.vy[i], previous.vy[i]) &&
+                sameBits(f.mass[i], previous.mass[i]) &&
+                sameBits(f.radius[i], previous.radius[i])) {
+                continue;
+            }
+
+            trajectory::DeltaRecord r;
+            std::memset(&r, 0, sizeof(r));
+            r.row = static_cast<std::uint32_t>(i);
+            r.active = f.active[i];
+            r.x = f.x[i];
+            r.y = f.y[i];
+            r.vx = f.vx[i];
+            r.vy = f.vy[i];
+            r.mass = f.mass[i];
+            r.radius = f.radius[i];
+            records.push_back(r);
+        }
+
+        beginStepRecord(trajectory::kDeltaTag, f, records.size());
+        if (!records.empty()) {
+            writeRaw(records.data(), records.size() * sizeof(trajectory::DeltaRecord));
+        }
+        writeEvents(f);
+    }
+
+    // El próximo paso se compara con este (los vectores se reutilizan)
+    previous.time = f.time;
+    previous.id = f.id;
+    previous.x = f.x;
+    previous.y = f.y;
+    previous.vx = f.vx;
+    previous.vy = f.vy;
+    previous.mass = f.mass;
+    previous.radius = f.radius;
+    previous.active = f.active;
+
+    sinceKeyframe = (sinceKeyframe + 1) % keyframeEvery;
+}
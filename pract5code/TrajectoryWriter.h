@@ -0,0 +1,159 @@
+#ifndef TRAJECTORYWRITER_H
+#define TRAJECTORYWRITER_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "CollisionEvent.h"
+#include "TrajectoryFormat.h"
+#include "ParticleStore.h"
+
+class Box;
+
+// Copia del estado de un paso, lista para escribir. Las columnas están en
+// orden de inserción. Se reutiliza entre pasos para no volver a reservar.
+struct StepFrame {
+    double time = 0.0;
+    std::vector<CollisionEvent> events;
+
+    std::vector<std::int32_t> id;
+    std::vector<double> x, y, vx, vy, mass, radius;
+    std::vector<std::uint8_t> active;
+
+    std::size_t count() const { return id.size(); }
+
+    void capture(double time, const ParticleStore& particles,
+                 const std::vector<CollisionEvent>& events);
+};
+
+enum class OutputFormat {
+    Text,   // líneas COLLISION / STATE de siempre
+    Binary, // columnas de ancho fijo, ver TrajectoryFormat.h
+    Delta,  // binario con keyframes y solo los cambios entre medio
+    None    // no escribe nada (las colisiones siguen yendo a eventSink)
+};
+
+// Destino de la salida de Simulation::run. Cada paso recibe las colisiones
+// del paso y el estado de todas las partículas.
+//
+// La simulación pide un frame con beginStep(), lo llena y lo entrega con
+// commitStep(). Por defecto eso escribe en el momento; AsyncTrajectoryWriter
+// lo pasa a otro hilo.
+class TrajectoryWriter {
+public:
+    virtual ~TrajectoryWriter() {}
+
+    virtual StepFrame& beginStep() { return frame; }
+    virtual void commitStep() { writeStep(frame); }
+
+    virtual bool open(const std::string& path) = 0;
+    virtual void writeHeader(std::size_t numParticles, double dt,
+                             double totalTime, const Box& box) = 0;
+    virtual void writeStep(const StepFrame& frame) = 0;
+    virtual void close() = 0;
+
+    // Bytes que quedaron en el archivo (válido después de close())
+    virtual std::uint64_t bytesWritten() const = 0;
+
+    // false si no hace falta llenar frames (no se escribe nada)
+    virtual bool needsFrames() const { return true; }
+
+    // keyframeEvery solo se usa con OutputFormat::Delta y textIndex con
+    // OutputFormat::Text
+    static std::unique_ptr<TrajectoryWriter> create(OutputFormat format,
+                                                    int keyframeEvery = 50,
+                                                    bool textIndex = false);
+
+private:
+    StepFrame frame;
+};
+
+// OutputFormat::None: para benchmarks o para usar la simulación desde otro
+// programa sin tocar el disco
+class NullTrajectoryWriter : public TrajectoryWriter {
+public:
+    bool open(const std::string&) override { return true; }
+    void writeHeader(std::size_t, double, double, const Box&) override {}
+    void writeStep(const StepFrame&) override {}
+    void close() override {}
+    std::uint64_t bytesWritten() const override { return 0; }
+    bool needsFrames() const override { return false; }
+};
+
+class TextTrajectoryWriter : public TrajectoryWriter {
+public:
+    // Con writeIndex escribe además <path>.idx (ver TrajectoryFormat.h y
+    // reader/TextLogReader.h) para ir directo a cualquier paso
+    explicit TextTrajectoryWriter(bool writeIndex = false);
+
+    bool open(const std::string& path) override;
+    void writeHeader(std::size_t numParticles, double dt,
+                     double totalTime, const Box& box) override;
+    void writeStep(const StepFrame& frame) override;
+    void close() override;
+    std::uint64_t bytesWritten() const override { return written; }
+
+    // Formato de texto de una colisión (sin salto de línea)
+    static void writeEvent(std::ostream& out, const CollisionEvent& e);
+
+    static std::string indexPathFor(const std::string& logPath) { return logPath + ".idx"; }
+
+private:
+    std::ofstream log;
+    std::uint64_t written = 0;
+
+    bool writeIndex;
+    std::string indexPath;
+    trajectory::TextIndexHeader indexHeader;
+    std::vector<trajectory::TextIndexEntry> index;
+
+    std::uint64_t position() { return static_cast<std::uint64_t>(log.tellp()); }
+    bool saveIndex();
+};
+
+class BinaryTrajectoryWriter : public TrajectoryWriter {
+public:
+    bool open(const std::string& path) override;
+    void writeHeader(std::size_t numParticles, double dt,
+                     double totalTime, const Box& box) override;
+    void writeStep(const StepFrame& frame) override;
+    void close() override;
+    std::uint64_t bytesWritten() const override { return offset; }
+
+protected:
+    std::uint32_t headerFlags = 0;
+    double stepDt = 0.0;
+
+    void writeRaw(const void* data, std::size_t bytes);
+    // StepHeader + columnas completas + colisiones
+    void writeFullStep(const StepFrame& frame);
+    void writeEvents(const StepFrame& frame);
+    void beginStepRecord(std::uint32_t tag, const StepFrame& frame,
+                         std::uint64_t count);
+
+private:
+    std::ofstream out;
+    std::uint64_t offset = 0;
+    std::vector<std::uint64_t> stepOffsets;
+};
+
+// Binario con keyframes cada 'keyframeEvery' pasos y, entre medio, solo las
+// filas que cambiaron (ver TrajectoryFormat.h). TrajectoryReader::readStep
+// reconstruye cualquier paso exacto.
+class DeltaTrajectoryWriter : public BinaryTrajectoryWriter {
+public:
+    explicit DeltaTrajectoryWriter(int keyframeEvery);
+
+    bool open(const std::string& path) override;
+    void writeStep(const StepFrame& frame) override;
+
+private:
+    int keyframeEvery;
+    int sinceKeyframe;
+    StepFrame previous;   // último paso escrito
+    std::vector<trajectory::DeltaRecord> records;
+};
+
+#endif // TRAJECTORYWRITER_H
@@ -0,0 +1,39 @@
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Conjuntos disjuntos sobre 0..n-1. La raíz de cada conjunto es siempre su
+// elemento más chico, así el resultado no depende del orden de las uniones.
+class UnionFind {
+public:
+    void reset(std::size_t n) {
+        parent.resize(n);
+        for (std::size_t i = 0; i < n; ++i) parent[i] = i;
+    }
+
+    std::size_t find(std::size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]]; // compresión a la mitad
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(std::size_t a, std::size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (b < a) std::swap(a, b);
+        parent[b] = a;
+    }
+
+    std::size_t size() const { return parent.size(); }
+
+private:
+    std::vector<std::size_t> parent;
+};
+
+#endif // UNIONFIND_H
@@ -1,22 +1,52 @@
 #ifndef VEC2_H
 #define VEC2_H
 
-class Vec2 {
+#include <cmath>
+
+// Vector 2D sobre el tipo de punto flotante T. Todo inline y constexpr
+// donde se puede: se usa en los ciclos internos de la simulación.
+template <typename T>
+class Vec2T {
 public:
-    double x;
-    double y;
+    T x;
+    T y;
+
+    constexpr Vec2T(T x_ = T(0), T y_ = T(0)) : x(x_), y(y_) {}
+
+    constexpr Vec2T operator+(const Vec2T& other) const {
+        return Vec2T(x + other.x, y + other.y);
+    }
+
+    constexpr Vec2T operator-(const Vec2T& other) const {
+        return Vec2T(x - other.x, y - other.y);
+    }
 
-    Vec2(double x_ = 0.0, double y_ = 0.0);
+    constexpr Vec2T operator*(T s) const {
+        return Vec2T(x * s, y * s);
+    }
 
-    Vec2 operator+(const Vec2& other) const;
-    Vec2 operator-(const Vec2& other) const;
-    Vec2 operator*(double s) const;
-    Vec2& operator+=(const Vec2& other);
+    constexpr Vec2T& operator+=(const Vec2T& other) {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
 
-    double dot(const Vec2& other) const;
-    double length() const;
-    Vec2 normalized() const;
+    constexpr T dot(const Vec2T& other) const {
+        return x * other.x + y * other.y;
+    }
+
+    T length() const {
+        return std::sqrt(x * x + y * y);
+    }
+
+    Vec2T normalized() const {
+        T len = length();
+        if (len == T(0)) return Vec2T(T(0), T(0));
+        return Vec2T(x / len, y / len);
+    }
 };
 
-#endif // VEC2_H
+typedef Vec2T<double> Vec2;
+typedef Vec2T<float> Vec2f;
 
+#endif // VEC2_H
@@ -0,0 +1,12 @@
+# Benchmark de las fases de Simulation::run (ver bench/main.cpp)
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = p5bench
+
+include(../simcore.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,328 @@
+// Benchmark de las fases de un paso de Simulation (integrar, paredes,
+// obstáculos, pares y registro) sobre un barrido de cantidad de partículas,
+// ocupación de la caja y cantidad de obstáculos.
+//
+// Uso: p5bench [--counts 1000,10000] [--fill 0.05,0.2] [--obstacles 0,64]
+//              [--steps N] [--threads N] [--format text|binary|delta|none]
+//              [--async] [--merge sequential|clusters] [--reorder N]
+//              [--scalar] [--seed S] [--out bench.json]
+//
+// Escribe una tabla legible por consola y los resultados en JSON (--out)
+// para comparar entre versiones.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "Scenario.h"
+#include "SimdKernels.h"
+#include "PhaseProfile.h"
+
+// Contador global de reservas de memoria (todas las llamadas a operator new,
+// de cualquier hilo)
+static std::atomic<std::uint64_t> allocationCount(0);
+
+static std::uint64_t currentAllocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+struct BenchConfig {
+    std::vector<std::size_t> counts{1000, 10000, 100000};
+    std::vector<double> fills{0.05, 0.2};      // fracción del área ocupada
+    std::vector<std::size_t> obstacles{0, 64, 1024};
+    int steps = 50;
+    double dt = 0.01;
+    unsigned threads = 1;
+    OutputFormat format = OutputFormat::Text;
+    bool async = false;
+    MergeMode merge = MergeMode::Sequential;
+    int reorderEvery = 0;
+    std::uint64_t seed = 1;
+    std::string outFile = "bench.json";
+};
+
+struct BenchResult {
+    std::size_t requested;
+    std::size_t placed;
+    double fill;
+    std::size_t obstacles;
+    double side;
+    PhaseProfile profile;
+};
+
+static const double kMinRadius = 0.5;
+static const double kMaxRadius = 1.0;
+
+// Lado de una caja cuadrada donde 'count' partículas ocupan 'fill' del área
+static double boxSideFor(std::size_t count, double fill) {
+    // E[r^2] con r uniforme en [a, b]
+    double a = kMinRadius, b = kMaxRadius;
+    double meanR2 = (a * a + a * b + b * b) / 3.0;
+    double area = static_cast<double>(count) * M_PI * meanR2 / fill;
+    return std::sqrt(area);
+}
+
+// Obstáculos en una grilla regular; juntos cubren a lo sumo el 10% de la caja
+static void addObstacleGrid(Simulation& sim, std::size_t count, double side) {
+    if (count == 0) return;
+    std::size_t perRow = static_cast<std::size_t>(std::ceil(std::sqrt(double(count))));
+    double cell = side / perRow;
+    double halfSize = std::min(2.0, 0.5 * std::sqrt(0.1 * side * side / count));
+    for (std::size_t k = 0; k < count; ++k) {
+        double cx = (k % perRow + 0.5) * cell;
+        double cy = (k / perRow + 0.5) * cell;
+        sim.addObstacle(Obstacle(Vec2(cx, cy), halfSize));
+    }
+}
+
+static BenchResult runOne(const BenchConfig& config, std::size_t count,
+                          double fill, std::size_t numObstacles,
+                          const std::string& scratchFile) {
+    BenchResult result;
+    result.requested = count;
+    result.fill = fill;
+    result.obstacles = numObstacles;
+    result.side = boxSideFor(count, fill);
+
+    // Medio paso de margen para que totalTime / dt no pierda el último paso
+    double totalTime = (config.steps - 1 + 0.5) * config.dt;
+    Simulation sim(result.side, result.side, config.dt, totalTime, 0.6);
+    sim.numThreads = config.threads;
+    sim.outputFormat = config.format;
+    sim.asyncOutput = config.async;
+    sim.mergeMode = config.merge;
+    sim.reorderEvery = config.reorderEvery;
+    sim.particles.reserve(count);
+    addObstacleGrid(sim, numObstacles, result.side);
+
+    GeneratorConfig generator;
+    generator.count = count;
+    generator.seed = config.seed;
+    generator.minRadius = kMinRadius;
+    generator.maxRadius = kMaxRadius;
+    result.placed = generateParticles(sim, generator);
+
+    result.profile.allocationCounter = currentAllocations;
+    sim.profile = &result.profile;
+
+    // run() avisa por consola al terminar; acá solo ensucia la tabla
+    std::streambuf* coutBuf = std::cout.rdbuf(nullptr);
+    sim.run(scratchFile);
+    std::cout.rdbuf(coutBuf);
+    std::remove(scratchFile.c_str());
+    return result;
+}
+
+static double perParticleStep(std::uint64_t ns, const PhaseProfile& p) {
+    return p.particleSteps ? double(ns) / double(p.particleSteps) : 0.0;
+}
+
+static double perStep(std::uint64_t n, const PhaseProfile& p) {
+    return p.steps ? double(n) / double(p.steps) : 0.0;
+}
+
+static void printTable(const std::vector<BenchResult>& results) {
+    std::cout << std::left << std::setw(9) << "n" << std::setw(7) << "fill"
+              << std::setw(7) << "obst";
+    for (std::size_t k = 0; k < kNumPhases; ++k) {
+        std::cout << std::right << std::setw(11) << phaseName(static_cast<Phase>(k));
+    }
+    std::cout << std::setw(11) << "total" << std::setw(11) << "allocs/st" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const BenchResult& r : results) {
+        const PhaseProfile& p = r.profile;
+        std::cout << std::left << std::setw(9) << r.placed << std::setw(7) << r.fill
+                  << std::setw(7) << r.obstacles << std::right;
+        std::uint64_t allocs = 0;
+        for (std::size_t k = 0; k < kNumPhases; ++k) {
+            std::cout << std::setw(11) << perParticleStep(p.ns[k], p);
+            allocs += p.allocations[k];
+        }
+        std::cout << std::setw(11) << perParticleStep(p.totalNs(), p)
+                  << std::setw(11) << perStep(allocs, p) << "\n";
+    }
+    std::cout << "(ns por partícula por paso)\n";
+}
+
+static const char* formatName(OutputFormat format) {
+    switch (format) {
+    case OutputFormat::Binary: return "binary";
+    case OutputFormat::Delta:  return "delta";
+    case OutputFormat::None:   return "none";
+    default:                   return "text";
+    }
+}
+
+static bool writeJson(const BenchConfig& config,
+                      const std::vector<BenchResult>& results) {
+    std::ofstream out(config.outFile);
+    if (!out) return false;
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"benchmark\": \"pract5code-phases\",\n";
+    out << "  \"schema\": 1,\n";
+    out << "  \"isa\": \"" << kernels::activeIsa() << "\",\n";
+    out << "  \"threads\": " << config.threads << ",\n";
+    out << "  \"format\": \"" << formatName(config.format) << "\",\n";
+    out << "  \"asyncOutput\": " << (config.async ? "true" : "false") << ",\n";
+    out << "  \"mergeMode\": \""
+        << (config.merge == MergeMode::Clusters ? "clusters" : "sequential") << "\",\n";
+    out << "  \"reorderEvery\": " << config.reorderEvery << ",\n";
+    out << "  \"dt\": " << config.dt << ",\n";
+    out << "  \"seed\": " << config.seed << ",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        const PhaseProfile& p = r.profile;
+        out << "    {\n";
+        out << "      \"particles\": " << r.requested << ",\n";
+        out << "      \"placed\": " << r.placed << ",\n";
+        out << "      \"fill\": " << r.fill << ",\n";
+        out << "      \"obstacles\": " << r.obstacles << ",\n";
+        out << "      \"boxSide\": " << r.side << ",\n";
+        out << "      \"steps\": " << p.steps << ",\n";
+        out << "      \"particleSteps\": " << p.particleSteps << ",\n";
+        out << "      \"phases\": {\n";
+        std::uint64_t allocs = 0;
+        for (std::size_t k = 0; k < kNumPhases; ++k) {
+            allocs += p.allocations[k];
+            out << "        \"" << phaseName(static_cast<Phase>(k)) << "\": {"
+                << "\"ns\": " << p.ns[k]
+                << ", \"nsPerParticleStep\": " << perParticleStep(p.ns[k], p)
+                << ", \"allocations\": " << p.allocations[k]
+                << ", \"allocationsPerStep\": " << perStep(p.allocations[k], p)
+                << "}" << (k + 1 < kNumPhases ? "," : "") << "\n";
+        }
+        out << "      },\n";
+        out << "      \"totalNsPerParticleStep\": " << perParticleStep(p.totalNs(), p) << ",\n";
+        out << "      \"allocationsPerStep\": " << perStep(allocs, p) << ",\n";
+        out << "      \"pairTests\": " << p.pairTests << ",\n";
+        out << "      \"merges\": " << p.merges << ",\n";
+        out << "      \"obstacleTests\": " << p.obstacleTests << ",\n";
+        out << "      \"obstacleHits\": " << p.obstacleHits << ",\n";
+        out << "      \"wallHits\": " << p.wallHits << ",\n";
+        out << "      \"bytesWritten\": " << p.bytesWritten << "\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+template <typename T>
+static bool parseList(const std::string& text, std::vector<T>& out) {
+    out.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::istringstream field(item);
+        T value;
+        if (!(field >> value)) return false;
+        out.push_back(value);
+    }
+    return !out.empty();
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--counts" && hasValue) {
+            ok = parseList(argv[++i], config.counts);
+        } else if (arg == "--fill" && hasValue) {
+            ok = parseList(argv[++i], config.fills);
+        } else if (arg == "--obstacles" && hasValue) {
+            ok = parseList(argv[++i], config.obstacles);
+        } else if (arg == "--steps" && hasValue) {
+            config.steps = std::atoi(argv[++i]);
+            ok = config.steps > 0;
+        } else if (arg == "--threads" && hasValue) {
+            int n = std::atoi(argv[++i]);
+            ok = n > 0;
+            config.threads = static_cast<unsigned>(n);
+        } else if (arg == "--format" && hasValue) {
+            std::string value = argv[++i];
+            if (value == "binary") config.format = OutputFormat::Binary;
+            else if (value == "text") config.format = OutputFormat::Text;
+            else if (value == "delta") config.format = OutputFormat::Delta;
+            else if (value == "none") config.format = OutputFormat::None;
+            else ok = false;
+        } else if (arg == "--async") {
+            config.async = true;
+        } else if (arg == "--merge" && hasValue) {
+            std::string value = argv[++i];
+            if (value == "sequential") config.merge = MergeMode::Sequential;
+            else if (value == "clusters") config.merge = MergeMode::Clusters;
+            else ok = false;
+        } else if (arg == "--reorder" && hasValue) {
+            config.reorderEvery = std::atoi(argv[++i]);
+            ok = config.reorderEvery >= 0;
+        } else if (arg == "--scalar") {
+            kernels::forceScalar(true);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--out" && hasValue) {
+            config.outFile = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Argumento inválido: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::string scratchFile = config.outFile + ".traj.tmp";
+    std::vector<BenchResult> results;
+    for (std::size_t count : config.counts) {
+        for (double fill : config.fills) {
+            for (std::size_t numObstacles : config.obstacles) {
+                results.push_back(runOne(config, count, fill, numObstacles, scratchFile));
+            }
+        }
+    }
+
+    printTable(results);
+    if (!writeJson(config, results)) {
+        std::cerr << "No se pudo escribir " << config.outFile << "\n";
+        return 1;
+    }
+    std::cout << "Resultados en " << config.outFile << "\n";
+    return 0;
+}
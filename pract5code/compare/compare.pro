@@ -0,0 +1,19 @@
+# Compara dos archivos de trayectorias binarios o delta, por ejemplo una
+# corrida en double con la misma corrida compilada con CONFIG += p5_float
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = p5compare
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        main.cpp \
+        ../reader/MappedFile.cpp \
+        ../reader/TrajectoryReader.cpp
+
+HEADERS += \
+    ../reader/MappedFile.h \
+    ../reader/TrajectoryReader.h
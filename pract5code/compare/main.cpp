@@ -0,0 +1,168 @@
+// Compara dos trayectorias (binarias o delta) paso a paso. Pensado para
+// decidir si la compilación en float (CONFIG += p5_float) es aceptable
+// comparándola con la misma corrida en double.
+//
+// Uso: p5compare <referencia.bin> <otra.bin> [--tolerance T] [--csv archivo]
+//
+// Por paso informa el error máximo y RMS de posición sobre las filas activas
+// en ambos archivos, las filas con distinto estado activo y la diferencia en
+// cantidad de colisiones. Con --tolerance devuelve 2 si el error máximo de
+// algún paso la supera.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "reader/TrajectoryReader.h"
+
+namespace {
+
+struct StepDiff {
+    double time = 0.0;
+    double maxError = 0.0;
+    double rmsError = 0.0;
+    std::size_t compared = 0;        // filas activas en ambos
+    std::size_t activeMismatch = 0;  // activa en uno y fusionada en el otro
+    long long eventDiff = 0;
+};
+
+// Las filas se comparan por posición: ambas corridas agregan las
+// partículas en el mismo orden
+StepDiff compareStep(const StepState& a, const StepState& b) {
+    StepDiff d;
+    d.time = a.time;
+    std::size_t n = std::min(a.count(), b.count());
+    d.activeMismatch = std::max(a.count(), b.count()) - n;
+    double sum2 = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a.active[i] != b.active[i]) {
+            ++d.activeMismatch;
+            continue;
+        }
+        if (!a.active[i]) continue;
+        double dx = a.x[i] - b.x[i];
+        double dy = a.y[i] - b.y[i];
+        double e2 = dx * dx + dy * dy;
+        d.maxError = std::max(d.maxError, std::sqrt(e2));
+        sum2 += e2;
+        ++d.compared;
+    }
+    if (d.compared > 0) d.rmsError = std::sqrt(sum2 / d.compared);
+    d.eventDiff = static_cast<long long>(b.events.size()) -
+                  static_cast<long long>(a.events.size());
+    return d;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string files[2];
+    int numFiles = 0;
+    std::string csvFile;
+    double tolerance = -1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--tolerance" && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        } else if (arg == "--csv" && hasValue) {
+            csvFile = argv[++i];
+        } else if (arg.compare(0, 2, "--") != 0 && numFiles < 2) {
+            files[numFiles++] = arg;
+        } else {
+            std::cerr << "Argumento inválido: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (numFiles != 2) {
+        std::cerr << "Uso: p5compare <referencia.bin> <otra.bin>"
+                     " [--tolerance T] [--csv archivo]\n";
+        return 1;
+    }
+
+    TrajectoryReader readers[2];
+    for (int f = 0; f < 2; ++f) {
+        if (!readers[f].open(files[f])) {
+            std::cerr << "No se pudo abrir " << files[f] << "\n";
+            return 1;
+        }
+    }
+
+    std::ofstream csv;
+    if (!csvFile.empty()) {
+        csv.open(csvFile);
+        if (!csv) {
+            std::cerr << "No se pudo escribir " << csvFile << "\n";
+            return 1;
+        }
+        csv << std::setprecision(17);
+        csv << "step,time,compared,maxError,rmsError,activeMismatch,eventDiff\n";
+    }
+
+    std::size_t steps = std::min(readers[0].numSteps(), readers[1].numSteps());
+    if (readers[0].numSteps() != readers[1].numSteps()) {
+        std::cout << "Aviso: cantidad de pasos distinta ("
+                  << readers[0].numSteps() << " y " << readers[1].numSteps()
+                  << "); se comparan los primeros " << steps << "\n";
+    }
+
+    StepState a, b;
+    StepDiff worst;
+    std::size_t worstStep = 0;
+    std::size_t firstDivergence = steps;     // primer paso con diferencia
+    std::size_t firstMismatch = steps;       // primer paso con otra topología
+    std::size_t stepsOverTolerance = 0;
+    for (std::size_t k = 0; k < steps; ++k) {
+        if (!readers[0].readStep(k, a) || !readers[1].readStep(k, b)) {
+            std::cerr << "Error al leer el paso " << k << "\n";
+            return 1;
+        }
+        StepDiff d = compareStep(a, b);
+        if (firstDivergence == steps &&
+            (d.maxError > 0.0 || d.activeMismatch > 0 || d.eventDiff != 0)) {
+            firstDivergence = k;
+        }
+        if (firstMismatch == steps && (d.activeMismatch > 0 || d.eventDiff != 0)) {
+            firstMismatch = k;
+        }
+        if (d.maxError > worst.maxError || k == 0) {
+            worst = d;
+            worstStep = k;
+        }
+        if (tolerance >= 0.0 && d.maxError > tolerance) ++stepsOverTolerance;
+        if (csv) {
+            csv << k << ',' << d.time << ',' << d.compared << ',' << d.maxError
+                << ',' << d.rmsError << ',' << d.activeMismatch << ','
+                << d.eventDiff << '\n';
+        }
+    }
+
+    std::cout << "Pasos comparados: " << steps << "\n";
+    if (firstDivergence == steps) {
+        std::cout << "Las trayectorias son idénticas\n";
+    } else {
+        std::cout << "Primera diferencia en el paso " << firstDivergence << "\n";
+        std::cout << "Error máximo de posición: " << worst.maxError
+                  << " (paso " << worstStep << ", t = " << worst.time
+                  << ", RMS " << worst.rmsError << ")\n";
+        if (firstMismatch == steps) {
+            std::cout << "Mismas fusiones y colisiones en todos los pasos\n";
+        } else {
+            std::cout << "Fusiones o colisiones distintas desde el paso "
+                      << firstMismatch << "\n";
+        }
+    }
+
+    if (tolerance >= 0.0) {
+        if (stepsOverTolerance > 0) {
+            std::cout << stepsOverTolerance << " pasos superan la tolerancia "
+                      << tolerance << "\n";
+            return 2;
+        }
+        std::cout << "Dentro de la tolerancia " << tolerance << "\n";
+    }
+    return 0;
+}
@@ -1,19 +1,43 @@
 #include <iostream>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
 #include "Simulation.h"
 #include "Particle.h"
 #include "Vec2.h"
 #include "Obstacle.h"
+#include "Scenario.h"
+#include "SimdKernels.h"
+#include "PhaseProfile.h"
+#include "Checkpoint.h"
+#include "Ensemble.h"
+#include "EventSink.h"
 
-int main() {
-    // Parámetros de la simulación
-    double width = 200.0;
-    double height = 100.0;
-    double dt = 0.01;
-    double totalTime = 5.0;
-    double e_obstaculo = 0.6;    // coeficiente de restitución inelástico
+// Compara dos archivos byte a byte
+static bool sameFileContents(const std::string& a, const std::string& b) {
+    std::ifstream fa(a, std::ios::binary);
+    std::ifstream fb(b, std::ios::binary);
+    if (!fa || !fb) return false;
+    return std::equal(std::istreambuf_iterator<char>(fa), std::istreambuf_iterator<char>(),
+                      std::istreambuf_iterator<char>(fb), std::istreambuf_iterator<char>());
+}
 
-    Simulation sim(width, height, dt, totalTime, e_obstaculo);
+// "salida.txt" + "_e0.8" -> "salida_e0.8.txt"
+static std::string withSuffix(const std::string& path, const std::string& suffix) {
+    std::size_t dot = path.find_last_of('.');
+    std::size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + suffix;
+    }
+    return path.substr(0, dot) + suffix + path.substr(dot);
+}
 
+// Escenario de ejemplo cuando no se pasa --scenario
+static void addDefaultScene(Simulation& sim) {
     // Partículas iniciales
     // id, position(x,y), velocity(vx,vy), mass, radius
     sim.addParticle(Particle(0, Vec2(20.0, 20.0), Vec2(10.0, 5.0), 1.0, 2.0));
@@ -26,8 +50,301 @@ int main() {
     sim.addObstacle(Obstacle(Vec2(80.0, 70.0), 5.0));
     sim.addObstacle(Obstacle(Vec2(120.0, 30.0), 5.0));
     sim.addObstacle(Obstacle(Vec2(160.0, 50.0), 5.0));
+}
+
+int main(int argc, char* argv[]) {
+    // Parámetros de la simulación
+    double width = 200.0;
+    double height = 100.0;
+    double dt = 0.01;
+    double totalTime = 5.0;
+    double e_obstaculo = 0.6;    // coeficiente de restitución inelástico
+
+    Simulation sim(width, height, dt, totalTime, e_obstaculo);
+
+    std::string outputFile;
+    std::string scenarioFile;
+    bool checkSerial = false;
+    bool printProfile = false;
+    bool countEvents = false;
+    std::string eventsFile;
+    std::string profileJson;
+    std::string resumeFile;
+    std::string ensembleFile;
+    std::vector<double> forkRestitutions;
+    double restitution = -1.0;   // < 0: la del escenario o del punto de control
+    GeneratorConfig generator;
+    generator.count = 0;
+
+    // --scenario archivo: caja, dt, partículas y obstáculos (ver Scenario.h)
+    // --generate N [--seed S]: agrega N partículas al azar sin superponer
+    // --brute-force: desactiva la grilla y el índice de obstáculos
+    //                (para comparar resultados)
+    // --format text|binary|delta|none, --output archivo (none: no escribe)
+    // --keyframe-every K: con --format delta, un paso completo cada K
+    // --text-index: con --format text, escribe también <salida>.idx para
+    //               leer cualquier paso sin recorrer el log (TextLogReader)
+    // --sync-output: escribe en el mismo hilo de la simulación
+    // --threads N: pasos en paralelo con N hilos
+    // --check-serial: repite la corrida con 1 hilo y compara las salidas
+    // --merge sequential|clusters: fusiones una por una en orden de slot, o
+    //                               cada grupo que se toca de una vez
+    // --reorder N [--reorder-threshold f]: cada N pasos reordena la memoria
+    //                                     en orden Z si el desorden pasa f
+    // --scalar: no usa los kernels AVX2
+    // --engine fixed|event: paso fijo o por eventos (tiempo de impacto)
+    // --profile: resumen de tiempos y contadores por fase al terminar
+    // --count-events: cuenta las colisiones por tipo (CountingEventSink)
+    // --events-text archivo: solo las líneas COLLISION*, aparte del log
+    // --profile-json archivo: el mismo resumen en JSON
+    // --restitution e: coeficiente de restitución con los obstáculos
+    // --adaptive [--min-dt h] [--max-dt h] [--step-safety f]: subpasos
+    //            adaptivos dentro de cada dt (el registro sigue cada dt)
+    // --checkpoint-every N [--checkpoint archivo]: punto de control cada N pasos
+    // --resume archivo: sigue desde un punto de control (salida desde ese paso)
+    // --fork e1,e2,...: con --resume, una continuación por cada restitución
+    // --ensemble barrido.txt: muchas corridas en paralelo (ver Ensemble.h);
+    //                         --threads N = corridas simultáneas
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--scenario" && i + 1 < argc) {
+            scenarioFile = argv[++i];
+        } else if (arg == "--generate" && i + 1 < argc) {
+            generator.count = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            generator.seed = std::stoull(argv[++i]);
+        } else if (arg == "--brute-force") {
+            sim.useSpatialGrid = false;
+            sim.useObstacleIndex = false;
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format == "text") {
+                sim.outputFormat = OutputFormat::Text;
+            } else if (format == "binary") {
+                sim.outputFormat = OutputFormat::Binary;
+            } else if (format == "delta") {
+                sim.outputFormat = OutputFormat::Delta;
+            } else if (format == "none") {
+                sim.outputFormat = OutputFormat::None;
+            } else {
+                std::cerr << "Formato desconocido: " << format << "\n";
+                return 1;
+            }
+        } else if (arg == "--text-index") {
+            sim.textIndex = true;
+        } else if (arg == "--keyframe-every" && i + 1 < argc) {
+            int k = std::stoi(argv[++i]);
+            sim.keyframeEvery = k > 0 ? k : 1;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            int n = std::stoi(argv[++i]);
+            sim.numThreads = n > 0 ? static_cast<unsigned>(n) : 1;
+        } else if (arg == "--engine" && i + 1 < argc) {
+            std::string engine = argv[++i];
+            if (engine == "fixed") {
+                sim.engine = SimulationEngine::FixedStep;
+            } else if (engine == "event") {
+                sim.engine = SimulationEngine::EventDriven;
+            } else {
+                std::cerr << "Motor desconocido: " << engine << "\n";
+                return 1;
+            }
+        } else if (arg == "--merge" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "sequential") {
+                sim.mergeMode = MergeMode::Sequential;
+            } else if (mode == "clusters") {
+                sim.mergeMode = MergeMode::Clusters;
+            } else {
+                std::cerr << "Modo de fusión desconocido: " << mode << "\n";
+                return 1;
+            }
+        } else if (arg == "--reorder" && i + 1 < argc) {
+            int n = std::stoi(argv[++i]);
+            sim.reorderEvery = n > 0 ? n : 0;
+        } else if (arg == "--reorder-threshold" && i + 1 < argc) {
+            sim.reorderThreshold = std::stod(argv[++i]);
+        } else if (arg == "--scalar") {
+            kernels::forceScalar(true);
+        } else if (arg == "--profile") {
+            printProfile = true;
+        } else if (arg == "--count-events") {
+            countEvents = true;
+        } else if (arg == "--events-text" && i + 1 < argc) {
+            eventsFile = argv[++i];
+        } else if (arg == "--profile-json" && i + 1 < argc) {
+            profileJson = argv[++i];
+        } else if (arg == "--adaptive") {
+            sim.adaptiveStep = true;
+        } else if (arg == "--min-dt" && i + 1 < argc) {
+            sim.minDt = std::stod(argv[++i]);
+        } else if (arg == "--max-dt" && i + 1 < argc) {
+            sim.maxDt = std::stod(argv[++i]);
+        } else if (arg == "--step-safety" && i + 1 < argc) {
+            sim.stepSafety = std::stod(argv[++i]);
+        } else if (arg == "--restitution" && i + 1 < argc) {
+            restitution = std::stod(argv[++i]);
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            sim.checkpointEvery = std::stoi(argv[++i]);
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            sim.checkpointFile = argv[++i];
+        } else if (arg == "--resume" && i + 1 < argc) {
+            resumeFile = argv[++i];
+        } else if (arg == "--ensemble" && i + 1 < argc) {
+            ensembleFile = argv[++i];
+        } else if (arg == "--fork" && i + 1 < argc) {
+            std::istringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                forkRestitutions.push_back(std::stod(item));
+            }
+        } else if (arg == "--check-serial") {
+            checkSerial = true;
+        } else if (arg == "--sync-output") {
+            sim.asyncOutput = false;
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            std::cerr << "Argumento desconocido: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    // Con estos valores el subpaso no tiene sentido (o la cantidad de
+    // subpasos no entra en un int)
+    if (!(sim.minDt > 0.0) || !(sim.minDt <= sim.maxDt) || !(sim.stepSafety > 0.0)) {
+        std::cerr << "--min-dt y --step-safety deben ser positivos y --min-dt <= --max-dt\n";
+        return 1;
+    }
+
+    if (!resumeFile.empty()) {
+        if (!scenarioFile.empty() || generator.count > 0) {
+            std::cerr << "--resume no se combina con --scenario ni --generate\n";
+            return 1;
+        }
+        if (sim.engine != SimulationEngine::FixedStep) {
+            std::cerr << "Los puntos de control son solo para el motor de paso fijo\n";
+            return 1;
+        }
+        std::string error;
+        if (!loadCheckpoint(resumeFile, sim, error)) {
+            std::cerr << "Error en el punto de control: " << error << "\n";
+            return 1;
+        }
+    } else if (!forkRestitutions.empty()) {
+        std::cerr << "--fork necesita --resume\n";
+        return 1;
+    } else if (!scenarioFile.empty()) {
+        std::string error;
+        if (!loadScenario(scenarioFile, sim, error)) {
+            std::cerr << "Error en el escenario: " << error << "\n";
+            return 1;
+        }
+    } else if (generator.count == 0) {
+        addDefaultScene(sim);
+    }
+
+    if (generator.count > 0) {
+        std::size_t placed = generateParticles(sim, generator);
+        if (placed < generator.count) {
+            std::cerr << "Aviso: solo se ubicaron " << placed << " de "
+                      << generator.count << " partículas\n";
+        }
+    }
+
+    if (outputFile.empty()) {
+        outputFile = (sim.outputFormat != OutputFormat::Text)
+                         ? "simulacion.bin"
+                         : "simulacion.txt";
+    }
+    if (sim.checkpointEvery > 0 && sim.checkpointFile.empty()) {
+        sim.checkpointFile = "simulacion.ckpt";
+    }
+    if (restitution >= 0.0) sim.obstacleRestitution = restitution;
+
+    if (!ensembleFile.empty()) {
+        EnsembleSpec spec;
+        std::string error;
+        if (!loadEnsembleSpec(ensembleFile, spec, error)) {
+            std::cerr << "Error en el barrido: " << error << "\n";
+            return 1;
+        }
+        if (spec.workers == 0 && sim.numThreads > 1) spec.workers = sim.numThreads;
+
+        std::vector<EnsembleRun> runs;
+        bool ok = runEnsemble(spec, sim, runs);
+        for (const EnsembleRun& r : runs) {
+            std::cout << "#" << r.index << " dt=" << r.dt << " e=" << r.restitution
+                      << " v*" << r.velocityScale << " semilla=" << r.velocitySeed
+                      << (r.ok ? "" : " ERROR") << " " << r.seconds << " s, "
+                      << r.alive << " vivas -> " << r.output << "\n";
+        }
+        std::cout << runs.size() << " corridas. Resumen en " << spec.summaryFile << "\n";
+        return ok ? 0 : 1;
+    }
+
+    // Una continuación por restitución, cada una con su salida y su punto
+    // de control
+    if (!forkRestitutions.empty()) {
+        bool allOk = true;
+        for (double e : forkRestitutions) {
+            std::ostringstream suffix;
+            suffix << "_e" << e;
+            Simulation fork(sim);
+            fork.obstacleRestitution = e;
+            if (!fork.checkpointFile.empty()) {
+                fork.checkpointFile = withSuffix(fork.checkpointFile, suffix.str());
+            }
+            if (!fork.run(withSuffix(outputFile, suffix.str()))) allOk = false;
+        }
+        return allOk ? 0 : 1;
+    }
+
+    // Copia del estado inicial para la corrida de verificación
+    std::unique_ptr<Simulation> serial;
+    if (checkSerial) serial.reset(new Simulation(sim));
+
+    PhaseProfile profile;
+    if (printProfile || !profileJson.empty()) sim.profile = &profile;
+
+    // Varios destinos de colisiones: se los reparte uno que los reenvía
+    CountingEventSink counter;
+    std::ofstream eventsOut;
+    std::unique_ptr<TextEventSink> eventsText;
+    std::vector<EventSink*> sinks;
+    if (countEvents) sinks.push_back(&counter);
+    if (!eventsFile.empty()) {
+        eventsOut.open(eventsFile);
+        if (!eventsOut) {
+            std::cerr << "No se pudo abrir " << eventsFile << "\n";
+            return 1;
+        }
+        eventsText.reset(new TextEventSink(eventsOut));
+        sinks.push_back(eventsText.get());
+    }
+    FanOutEventSink fanOut(sinks);
+    if (!sinks.empty()) sim.eventSink = &fanOut;
+
+    bool ok = sim.run(outputFile);
+    sim.eventSink = nullptr;
+    if (!ok) return 1;
+
+    if (countEvents) counter.print(std::cout);
+    if (printProfile) profile.printSummary(std::cout);
+    if (!profileJson.empty() && !profile.writeJson(profileJson)) {
+        std::cerr << "No se pudo escribir " << profileJson << "\n";
+    }
 
-    sim.run("simulacion.txt");
+    if (serial) {
+        std::string serialFile = outputFile + ".serial";
+        serial->numThreads = 1;
+        if (!serial->run(serialFile)) return 1;
+        if (!sameFileContents(outputFile, serialFile)) {
+            std::cerr << "La salida con " << sim.numThreads
+                      << " hilos difiere de la secuencial (" << serialFile << ")\n";
+            return 2;
+        }
+        std::cout << "Salida idéntica a la secuencial\n";
+    }
 
     return 0;
 }
@@ -1,19 +1,16 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
+include(simcore.pri)
+
+p5_float: TARGET = pract5code_float
+
 SOURCES += \
-        Box.cpp \
-        Obstacle.cpp \
-        Particle.cpp \
-        Simulation.cpp \
-        Vec2.cpp \
         main.cpp
 
-HEADERS += \
-    Box.h \
-    Obstacle.h \
-    Particle.h \
-    Simulation.h \
-    Vec2.h
+DISTFILES += \
+    scenarios/barrido.txt \
+    scenarios/basico.txt \
+    scenarios/gas_grande.txt
@@ -0,0 +1,312 @@
+#include "TextLogReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// Recorre un bloque de texto mapeado (sin '\0' al final) token por token
+class Cursor {
+public:
+    Cursor(const char* begin, const char* end_) : p(begin), end(end_) {}
+
+    bool atEnd() const { return p >= end; }
+    const char* position() const { return p; }
+
+    // true si la línea actual empieza con 'word'
+    bool startsWith(const char* word) const {
+        std::size_t n = std::strlen(word);
+        return static_cast<std::size_t>(end - p) >= n && std::memcmp(p, word, n) == 0;
+    }
+
+    bool blankLine() const { return p < end && *p == '\n'; }
+
+    void nextLine() {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        p = nl ? nl + 1 : end;
+    }
+
+    bool token(const char*& begin, std::size_t& length) {
+        while (p < end && *p == ' ') ++p;
+        begin = p;
+        while (p < end && *p != ' ' && *p != '\n') ++p;
+        length = static_cast<std::size_t>(p - begin);
+        return length > 0;
+    }
+
+    bool word(const char* expected) {
+        const char* begin;
+        std::size_t length;
+        return token(begin, length) && length == std::strlen(expected) &&
+               std::memcmp(begin, expected, length) == 0;
+    }
+
+    bool number(double& out) {
+        char buf[64];
+        if (!copyToken(buf, sizeof(buf))) return false;
+        char* stop = nullptr;
+        out = std::strtod(buf, &stop);
+        return *stop == '\0';
+    }
+
+    template <typename I>
+    bool integer(I& out) {
+        char buf[32];
+        if (!copyToken(buf, sizeof(buf))) return false;
+        char* stop = nullptr;
+        long long v = std::strtoll(buf, &stop, 10);
+        out = static_cast<I>(v);
+        return *stop == '\0';
+    }
+
+private:
+    const char* p;
+    const char* end;
+
+    bool copyToken(char* buf, std::size_t size) {
+        const char* begin;
+        std::size_t length;
+        if (!token(begin, length) || length >= size) return false;
+        std::memcpy(buf, begin, length);
+        buf[length] = '\0';
+        return true;
+    }
+};
+
+bool wallKind(Cursor& c, CollisionKind& kind) {
+    const char* begin;
+    std::size_t length;
+    if (!c.token(begin, length)) return false;
+    std::string w(begin, length);
+    if (w == "MURO_IZQ")       kind = CollisionKind::WallLeft;
+    else if (w == "MURO_DER")  kind = CollisionKind::WallRight;
+    else if (w == "MURO_ABAJ") kind = CollisionKind::WallBottom;
+    else if (w == "MURO_ARR")  kind = CollisionKind::WallTop;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+bool TextLogReader::open(const std::string& logPath, const std::string& indexPath) {
+    close();
+    if (!file.open(logPath)) return false;
+
+    std::string idx = indexPath.empty() ? logPath + ".idx" : indexPath;
+    fromIndexFile = loadIndex(idx);
+    if (!fromIndexFile && !buildIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TextLogReader::close() {
+    file.close();
+    entries.clear();
+    std::memset(&head, 0, sizeof(head));
+    fromIndexFile = false;
+}
+
+bool TextLogReader::loadIndex(const std::string& indexPath) {
+    std::ifstream in(indexPath, std::ios::binary);
+    if (!in) return false;
+
+    trajectory::TextIndexHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    if (std::memcmp(h.magic, trajectory::kTextIndexMagic, sizeof(h.magic)) != 0 ||
+        h.version != trajectory::kTextIndexVersion) {
+        return false;
+    }
+    // Un índice de otra corrida (o de un log que siguió creciendo) no sirve
+    if (h.logBytes != file.size()) return false;
+
+    // numSteps sale del archivo: antes de reservar se compara con lo que el
+    // .idx realmente trae (dividiendo, para no desbordar)
+    in.seekg(0, std::ios::end);
+    std::streamoff indexBytes = in.tellg();
+    if (indexBytes < static_cast<std::streamoff>(sizeof(h))) return false;
+    std::uint64_t rest = static_cast<std::uint64_t>(indexBytes) - sizeof(h);
+    if (rest % sizeof(trajectory::TextIndexEntry) != 0 ||
+        h.numSteps != rest / sizeof(trajectory::TextIndexEntry)) {
+        return false;
+    }
+    in.seekg(static_cast<std::streamoff>(sizeof(h)), std::ios::beg);
+
+    std::vector<trajectory::TextIndexEntry> loaded(h.numSteps);
+    in.read(reinterpret_cast<char*>(loaded.data()),
+            static_cast<std::streamsize>(loaded.size() * sizeof(trajectory::TextIndexEntry)));
+    if (!in) return false;
+    for (const trajectory::TextIndexEntry& e : loaded) {
+        if (e.endOffset > file.size() || e.offset > e.stateOffset ||
+            e.stateOffset > e.endOffset) {
+            return false;
+        }
+    }
+
+    head = h;
+    entries.swap(loaded);
+    return true;
+}
+
+bool TextLogReader::buildIndex() {
+    const char* base = reinterpret_cast<const char*>(file.data());
+    Cursor c(base, base + file.size());
+
+    // Cabecera: "# numParticles dt totalTime", los valores y una línea vacía
+    std::memcpy(head.magic, trajectory::kTextIndexMagic, sizeof(head.magic));
+    head.version = trajectory::kTextIndexVersion;
+    if (!c.startsWith("#")) return false;
+    c.nextLine();
+    if (!c.integer(head.numParticles) || !c.number(head.dt) || !c.number(head.totalTime)) {
+        return false;
+    }
+    c.nextLine();
+    if (c.blankLine()) c.nextLine();
+
+    std::uint64_t events = 0;
+    while (!c.atEnd()) {
+        trajectory::TextIndexEntry e;
+        e.offset = static_cast<std::uint64_t>(c.position() - base);
+        e.firstEvent = events;
+        e.eventCount = 0;
+        e.time = 0.0;
+        while (!c.atEnd() && c.startsWith("COLLISION")) {
+            ++e.eventCount;
+            c.nextLine();
+        }
+        e.stateOffset = static_cast<std::uint64_t>(c.position() - base);
+        bool haveTime = false;
+        while (!c.atEnd() && c.startsWith("STATE")) {
+            if (!haveTime) {
+                Cursor line(c);
+                line.word("STATE");
+                haveTime = line.number(e.time);
+            }
+            c.nextLine();
+        }
+        if (c.atEnd() || !c.blankLine()) break; // último paso incompleto
+        c.nextLine();
+        e.endOffset = static_cast<std::uint64_t>(c.position() - base);
+
+        // Sin partículas el tiempo sale de la primera colisión
+        if (!haveTime && e.eventCount > 0) {
+            Cursor line(base + e.offset, base + e.stateOffset);
+            const char* w;
+            std::size_t n;
+            line.token(w, n);
+            line.number(e.time);
+        }
+        entries.push_back(e);
+        events += e.eventCount;
+    }
+    head.numSteps = entries.size();
+    head.logBytes = file.size();
+    return true;
+}
+
+std::size_t TextLogReader::stepAtTime(double t) const {
+    if (entries.empty()) return 0;
+    // Los pasos están cada dt (un log reanudado no empieza en 0)
+    double k = head.dt > 0.0 ? std::floor((t - entries.front().time) / head.dt + 0.5) : 0.0;
+    std::size_t s = k <= 0.0 ? 0 : std::min(static_cast<std::size_t>(k), entries.size() - 1);
+    // Por redondeo de los tiempos, a lo sumo un paso de corrección
+    while (s > 0 && std::fabs(entries[s - 1].time - t) < std::fabs(entries[s].time - t)) --s;
+    while (s + 1 < entries.size() &&
+           std::fabs(entries[s + 1].time - t) < std::fabs(entries[s].time - t)) {
+        ++s;
+    }
+    return s;
+}
+
+void TextLogReader::stepRange(double t0, double t1,
+                              std::size_t& first, std::size_t& last) const {
+    auto byTime = [](const trajectory::TextIndexEntry& e, double t) { return e.time < t; };
+    auto firstAfter = [](double t, const trajectory::TextIndexEntry& e) { return t < e.time; };
+    first = std::lower_bound(entries.begin(), entries.end(), t0, byTime) - entries.begin();
+    last = std::upper_bound(entries.begin(), entries.end(), t1, firstAfter) - entries.begin();
+    if (last < first) last = first;
+}
+
+const char* TextLogReader::stepText(std::size_t k, std::size_t& length) const {
+    const trajectory::TextIndexEntry& e = entries[k];
+    length = static_cast<std::size_t>(e.endOffset - e.offset);
+    return reinterpret_cast<const char*>(file.data()) + e.offset;
+}
+
+bool TextLogReader::parseEvents(const char* p, const char* end,
+                                std::vector<CollisionEvent>& out) const {
+    Cursor c(p, end);
+    while (!c.atEnd()) {
+        CollisionEvent e;
+        e.other = -1;
+        e.into = -1;
+        bool ok;
+        if (c.startsWith("COLLISION_PO")) {
+            e.kind = CollisionKind::Obstacle;
+            ok = c.word("COLLISION_PO") && c.number(e.time) && c.integer(e.particle) &&
+                 c.word("OBSTACLE") && c.integer(e.other);
+        } else if (c.startsWith("COLLISION_PP")) {
+            e.kind = CollisionKind::Merge;
+            ok = c.word("COLLISION_PP") && c.number(e.time) && c.integer(e.particle) &&
+                 c.integer(e.other) && c.word("MERGE_INTO") && c.integer(e.into);
+        } else {
+            ok = c.word("COLLISION") && c.number(e.time) && c.integer(e.particle) &&
+                 wallKind(c, e.kind);
+        }
+        if (!ok) return false;
+        out.push_back(e);
+        c.nextLine();
+    }
+    return true;
+}
+
+bool TextLogReader::readEvents(std::size_t k, std::vector<CollisionEvent>& out) const {
+    if (k >= entries.size()) return false;
+    const trajectory::TextIndexEntry& e = entries[k];
+    const char* base = reinterpret_cast<const char*>(file.data());
+    out.clear();
+    out.reserve(static_cast<std::size_t>(e.eventCount));
+    return parseEvents(base + e.offset, base + e.stateOffset, out);
+}
+
+bool TextLogReader::readStep(std::size_t k, StepState& out) const {
+    if (!readEvents(k, out.events)) return false;
+
+    const trajectory::TextIndexEntry& e = entries[k];
+    const char* base = reinterpret_cast<const char*>(file.data());
+    Cursor c(base + e.stateOffset, base + e.endOffset);
+
+    out.time = e.time;
+    out.id.clear();
+    out.x.clear();
+    out.y.clear();
+    out.vx.clear();
+    out.vy.clear();
+    out.mass.clear();
+    out.radius.clear();
+    out.active.clear();
+
+    while (!c.atEnd() && !c.blankLine()) {
+        double t, x, y, vx, vy, mass, radius;
+        std::int32_t id;
+        int active;
+        if (!c.word("STATE") || !c.number(t) || !c.integer(id) ||
+            !c.number(x) || !c.number(y) || !c.number(vx) || !c.number(vy) ||
+            !c.number(mass) || !c.number(radius) || !c.integer(active)) {
+            return false;
+        }
+        out.id.push_back(id);
+        out.x.push_back(x);
+        out.y.push_back(y);
+        out.vx.push_back(vx);
+        out.vy.push_back(vy);
+        out.mass.push_back(mass);
+        out.radius.push_back(radius);
+        out.active.push_back(active ? 1 : 0);
+        c.nextLine();
+    }
+    return true;
+}
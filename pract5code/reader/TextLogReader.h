@@ -0,0 +1,59 @@
+#ifndef TEXTLOGREADER_H
+#define TEXTLOGREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "TrajectoryReader.h"
+#include "../TrajectoryFormat.h"
+
+// Lector del log de texto (simulacion.txt). Mapea el archivo y, con el
+// índice <log>.idx que escribe la simulación con --text-index, va directo
+// al bloque de cualquier paso y parsea solo ese. Si no hay índice, o no
+// corresponde al log, lo arma recorriendo el archivo una vez.
+class TextLogReader {
+public:
+    // indexPath vacío = <logPath>.idx
+    bool open(const std::string& logPath, const std::string& indexPath = "");
+    void close();
+
+    // true si se usó el índice del archivo (false = se armó recorriendo)
+    bool usedIndexFile() const { return fromIndexFile; }
+
+    std::size_t numSteps() const { return entries.size(); }
+    std::size_t numParticles() const { return static_cast<std::size_t>(head.numParticles); }
+    double dt() const { return head.dt; }
+    double totalTime() const { return head.totalTime; }
+
+    const trajectory::TextIndexEntry& entry(std::size_t k) const { return entries[k]; }
+    double time(std::size_t k) const { return entries[k].time; }
+
+    // Paso cuyo tiempo es el más cercano a t
+    std::size_t stepAtTime(double t) const;
+    // Pasos [first, last) con tiempo en [t0, t1]; first == last si no hay
+    void stepRange(double t0, double t1, std::size_t& first, std::size_t& last) const;
+
+    // Texto crudo del bloque del paso k (colisiones y estados), sin copiar
+    const char* stepText(std::size_t k, std::size_t& length) const;
+
+    // Parsea el paso k. Los números tienen la precisión con que se
+    // escribió el log.
+    bool readStep(std::size_t k, StepState& out) const;
+    // Solo las colisiones del paso k
+    bool readEvents(std::size_t k, std::vector<CollisionEvent>& out) const;
+
+private:
+    MappedFile file;
+    trajectory::TextIndexHeader head;
+    std::vector<trajectory::TextIndexEntry> entries;
+    bool fromIndexFile = false;
+
+    bool loadIndex(const std::string& indexPath);
+    bool buildIndex();
+    bool parseEvents(const char* p, const char* end,
+                     std::vector<CollisionEvent>& out) const;
+};
+
+#endif // TEXTLOGREADER_H
@@ -0,0 +1,211 @@
+#include "TrajectoryReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+bool TrajectoryReader::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    if (file.size() < sizeof(head)) {
+        close();
+        return false;
+    }
+    std::memcpy(&head, file.data(), sizeof(head));
+    if (std::memcmp(head.magic, trajectory::kMagic, sizeof(head.magic)) != 0 ||
+        head.version != trajectory::kVersion) {
+        close();
+        return false;
+    }
+
+    // Si el archivo quedó cortado no hay índice: se recorre paso por paso
+    if (!readIndex() && !scanSteps()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TrajectoryReader::close() {
+    file.close();
+    stepOffsets.clear();
+}
+
+// El índice viene del archivo: cada paso tiene que caber antes del índice,
+// igual que lo que exige scanSteps(). Si algo no cierra se recorre el archivo.
+bool TrajectoryReader::readIndex() {
+    if (file.size() < sizeof(head) + sizeof(trajectory::FileFooter)) return false;
+
+    trajectory::FileFooter f;
+    std::memcpy(&f, file.data() + file.size() - sizeof(f), sizeof(f));
+    if (std::memcmp(f.magic, trajectory::kFooterMagic, sizeof(f.magic)) != 0) return false;
+    std::uint64_t room = file.size() - sizeof(f);
+    if (f.indexOffset < sizeof(head) || f.indexOffset > room) return false;
+    if (f.numSteps > (room - f.indexOffset) / sizeof(std::uint64_t)) return false;
+    if (f.indexOffset + f.numSteps * sizeof(std::uint64_t) != room) return false;
+
+    stepOffsets.resize(f.numSteps);
+    if (f.numSteps > 0) {
+        std::memcpy(stepOffsets.data(), file.data() + f.indexOffset,
+                    f.numSteps * sizeof(std::uint64_t));
+    }
+
+    std::uint64_t end;
+    for (std::uint64_t offset : stepOffsets) {
+        if (offset < sizeof(head) || offset % alignof(double) != 0 ||
+            !stepEnd(offset, f.indexOffset, end)) {
+            stepOffsets.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TrajectoryReader::stepEnd(std::uint64_t offset, std::uint64_t limit,
+                               std::uint64_t& end) const {
+    if (offset > limit || limit - offset < sizeof(trajectory::StepHeader)) return false;
+
+    trajectory::StepHeader h;
+    std::memcpy(&h, file.data() + offset, sizeof(h));
+    if (h.tag != trajectory::kStepTag && h.tag != trajectory::kDeltaTag) return false;
+
+    // Cada fila y cada colisión ocupan al menos un byte: con esto los
+    // productos de abajo no se desbordan
+    if (h.count > limit || h.eventCount > limit) return false;
+    end = offset + sizeof(h) + trajectory::bodyBytes(h.tag, h.count) +
+          h.eventCount * sizeof(CollisionEvent);
+    return end <= limit;
+}
+
+bool TrajectoryReader::scanSteps() {
+    stepOffsets.clear();
+    std::uint64_t offset = sizeof(head);
+    std::uint64_t end;
+
+    // Para en el primer paso que no es paso o que quedó incompleto
+    while (stepEnd(offset, file.size(), end)) {
+        stepOffsets.push_back(offset);
+        offset = end;
+    }
+    return true;
+}
+
+trajectory::StepHeader TrajectoryReader::stepHeader(std::size_t k) const {
+    trajectory::StepHeader h;
+    std::memcpy(&h, file.data() + stepOffsets[k], sizeof(h));
+    return h;
+}
+
+bool TrajectoryReader::isKeyframe(std::size_t k) const {
+    return stepHeader(k).tag == trajectory::kStepTag;
+}
+
+StepView TrajectoryReader::step(std::size_t k) const {
+    const unsigned char* base = file.data() + stepOffsets[k];
+
+    trajectory::StepHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    const unsigned char* col = base + sizeof(h);
+    std::size_t n = static_cast<std::size_t>(h.count);
+
+    StepView v;
+    v.time = h.time;
+    v.eventCount = static_cast<std::size_t>(h.eventCount);
+    v.events = reinterpret_cast<const CollisionEvent*>(col + trajectory::bodyBytes(h.tag, n));
+
+    if (h.tag == trajectory::kDeltaTag) {
+        v.count = 0;
+        v.x = v.y = v.vx = v.vy = v.mass = v.radius = nullptr;
+        v.id = nullptr;
+        v.active = nullptr;
+        return v;
+    }
+
+    v.count = n;
+    v.x      = reinterpret_cast<const double*>(col);
+    v.y      = v.x + n;
+    v.vx     = v.y + n;
+    v.vy     = v.vx + n;
+    v.mass   = v.vy + n;
+    v.radius = v.mass + n;
+    v.id     = reinterpret_cast<const std::int32_t*>(v.radius + n);
+    v.active = reinterpret_cast<const std::uint8_t*>(v.id + n);
+    return v;
+}
+
+void TrajectoryReader::applyDelta(std::size_t k, StepState& state) const {
+    const unsigned char* base = file.data() + stepOffsets[k];
+    trajectory::StepHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    // Primero todas las filas avanzan como si nada hubiera pasado...
+    double dt = head.dt;
+    bool single = (head.flags & trajectory::kFlagFloatState) != 0;
+    for (std::size_t i = 0; i < state.count(); ++i) {
+        bool active = state.active[i] != 0;
+        if (single) {
+            state.x[i] = trajectory::predictPosition<float>(state.x[i], state.vx[i], dt, active);
+            state.y[i] = trajectory::predictPosition<float>(state.y[i], state.vy[i], dt, active);
+        } else {
+            state.x[i] = trajectory::predictPosition<double>(state.x[i], state.vx[i], dt, active);
+            state.y[i] = trajectory::predictPosition<double>(state.y[i], state.vy[i], dt, active);
+        }
+    }
+
+    // ...y después se pisan las que cambiaron
+    const unsigned char* rec = base + sizeof(h);
+    for (std::uint64_t r = 0; r < h.count; ++r) {
+        trajectory::DeltaRecord d;
+        std::memcpy(&d, rec + r * sizeof(d), sizeof(d));
+        if (d.row >= state.count()) continue;
+        state.x[d.row] = d.x;
+        state.y[d.row] = d.y;
+        state.vx[d.row] = d.vx;
+        state.vy[d.row] = d.vy;
+        state.mass[d.row] = d.mass;
+        state.radius[d.row] = d.radius;
+        state.active[d.row] = d.active;
+    }
+}
+
+bool TrajectoryReader::readStep(std::size_t k, StepState& out) const {
+    if (k >= stepOffsets.size()) return false;
+
+    // Keyframe anterior (o el mismo paso)
+    std::size_t key = k;
+    while (!isKeyframe(key)) {
+        if (key == 0) return false;
+        --key;
+    }
+
+    StepView v = step(key);
+    out.id.assign(v.id, v.id + v.count);
+    out.x.assign(v.x, v.x + v.count);
+    out.y.assign(v.y, v.y + v.count);
+    out.vx.assign(v.vx, v.vx + v.count);
+    out.vy.assign(v.vy, v.vy + v.count);
+    out.mass.assign(v.mass, v.mass + v.count);
+    out.radius.assign(v.radius, v.radius + v.count);
+    out.active.assign(v.active, v.active + v.count);
+
+    for (std::size_t s = key + 1; s <= k; ++s) {
+        applyDelta(s, out);
+    }
+
+    StepView last = step(k);
+    out.time = last.time;
+    out.events.assign(last.events, last.events + last.eventCount);
+    return true;
+}
+
+std::size_t TrajectoryReader::stepAtTime(double t) const {
+    if (stepOffsets.empty()) return 0;
+    // Los pasos están cada dt a partir del primero (un archivo reanudado
+    // no empieza en 0)
+    double first = step(0).time;
+    double k = head.dt > 0.0 ? std::floor((t - first) / head.dt + 0.5) : 0.0;
+    if (k <= 0.0) return 0;
+    std::size_t s = static_cast<std::size_t>(k);
+    return std::min(s, stepOffsets.size() - 1);
+}
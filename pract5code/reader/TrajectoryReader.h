@@ -0,0 +1,82 @@
+#ifndef TRAJECTORYREADER_H
+#define TRAJECTORYREADER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "../TrajectoryFormat.h"
+#include "../CollisionEvent.h"
+
+// Vista de un paso de un archivo binario de trayectorias. Los punteros
+// apuntan directo al archivo mapeado: son válidos mientras el lector siga
+// abierto.
+struct StepView {
+    double time;
+    std::size_t count;
+    const double* x;
+    const double* y;
+    const double* vx;
+    const double* vy;
+    const double* mass;
+    const double* radius;
+    const std::int32_t* id;
+    const std::uint8_t* active;
+
+    std::size_t eventCount;
+    const CollisionEvent* events;
+};
+
+// Copia completa de un paso, para archivos delta (o si se quiere copiar)
+struct StepState {
+    double time = 0.0;
+    std::vector<std::int32_t> id;
+    std::vector<double> x, y, vx, vy, mass, radius;
+    std::vector<std::uint8_t> active;
+    std::vector<CollisionEvent> events;
+
+    std::size_t count() const { return id.size(); }
+};
+
+// Lector de archivos escritos por BinaryTrajectoryWriter y
+// DeltaTrajectoryWriter
+class TrajectoryReader {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    const trajectory::FileHeader& header() const { return head; }
+    std::size_t numSteps() const { return stepOffsets.size(); }
+
+    bool isDelta() const { return (head.flags & trajectory::kFlagDelta) != 0; }
+    bool isKeyframe(std::size_t k) const;
+
+    // Vista sin copia del paso k (0 <= k < numSteps()). En archivos delta
+    // solo los keyframes tienen columnas; en los demás pasos la vista trae
+    // count = 0 y solo las colisiones.
+    StepView step(std::size_t k) const;
+
+    // Estado completo del paso k. En archivos delta parte del keyframe
+    // anterior y aplica los cambios paso a paso; el resultado es idéntico
+    // bit a bit a lo que escribió la simulación.
+    bool readStep(std::size_t k, StepState& out) const;
+
+    // Paso cuyo tiempo es el más cercano a t (suponiendo dt constante)
+    std::size_t stepAtTime(double t) const;
+
+private:
+    MappedFile file;
+    trajectory::FileHeader head;
+    std::vector<std::uint64_t> stepOffsets;
+
+    bool readIndex();
+    bool scanSteps();
+    // Fin del paso que empieza en 'offset'; false si no es un paso o no
+    // termina antes de 'limit'
+    bool stepEnd(std::uint64_t offset, std::uint64_t limit, std::uint64_t& end) const;
+    trajectory::StepHeader stepHeader(std::size_t k) const;
+    void applyDelta(std::size_t k, StepState& state) const;
+};
+
+#endif // TRAJECTORYREADER_H
@@ -0,0 +1,19 @@
+# Biblioteca para leer los archivos de trayectorias: binarios y delta
+# (TrajectoryReader) y el log de texto con su índice (TextLogReader)
+TEMPLATE = lib
+CONFIG += staticlib c++17
+CONFIG -= qt
+
+TARGET = trajreader
+
+SOURCES += \
+        MappedFile.cpp \
+        TextLogReader.cpp \
+        TrajectoryReader.cpp
+
+HEADERS += \
+    MappedFile.h \
+    TextLogReader.h \
+    TrajectoryReader.h \
+    ../CollisionEvent.h \
+    ../TrajectoryFormat.h
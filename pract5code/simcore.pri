@@ -0,0 +1,55 @@
+# Núcleo de la simulación (todo menos main.cpp). Lo usan pract5code.pro y
+# bench/bench.pro.
+CONFIG += c++17 thread
+
+INCLUDEPATH += $$PWD
+
+# Estado en float en vez de double (ver Scalar.h)
+p5_float: DEFINES += P5_FLOAT
+
+SOURCES += \
+        $$PWD/AsyncTrajectoryWriter.cpp \
+        $$PWD/Box.cpp \
+        $$PWD/Checkpoint.cpp \
+        $$PWD/Ensemble.cpp \
+        $$PWD/EventDrivenEngine.cpp \
+        $$PWD/EventSink.cpp \
+        $$PWD/MortonOrder.cpp \
+        $$PWD/Obstacle.cpp \
+        $$PWD/ObstacleIndex.cpp \
+        $$PWD/ParticleStore.cpp \
+        $$PWD/PhaseProfile.cpp \
+        $$PWD/Scenario.cpp \
+        $$PWD/SimdKernels.cpp \
+        $$PWD/Simulation.cpp \
+        $$PWD/SpatialGrid.cpp \
+        $$PWD/TaskPool.cpp \
+        $$PWD/ThreadPool.cpp \
+        $$PWD/TrajectoryWriter.cpp
+
+HEADERS += \
+    $$PWD/AsyncTrajectoryWriter.h \
+    $$PWD/Box.h \
+    $$PWD/Checkpoint.h \
+    $$PWD/CollisionEvent.h \
+    $$PWD/Ensemble.h \
+    $$PWD/EventDrivenEngine.h \
+    $$PWD/EventSink.h \
+    $$PWD/MortonOrder.h \
+    $$PWD/Obstacle.h \
+    $$PWD/ObstacleIndex.h \
+    $$PWD/Particle.h \
+    $$PWD/ParticleStore.h \
+    $$PWD/PhaseProfile.h \
+    $$PWD/Random.h \
+    $$PWD/Scalar.h \
+    $$PWD/Scenario.h \
+    $$PWD/SimdKernels.h \
+    $$PWD/Simulation.h \
+    $$PWD/SpatialGrid.h \
+    $$PWD/TaskPool.h \
+    $$PWD/ThreadPool.h \
+    $$PWD/TrajectoryFormat.h \
+    $$PWD/TrajectoryWriter.h \
+    $$PWD/UnionFind.h \
+    $$PWD/Vec2.h
@@ -0,0 +1,188 @@
+#include "CpuPlayer.h"
+#include "HeadlessGame.h"
+#include <cmath>
+
+namespace {
+
+// Límites de changeAngle y changePower
+const double kMinAngle = 5.0;
+const double kMaxAngle = 85.0;
+const double kMinPower = 30.0;
+const double kMaxPower = 350.0;
+
+} // namespace
+
+CpuPlayer::CpuPlayer(double angleStep_, double powerStep_)
+    : simulatedShots(0),
+    angleStep(angleStep_),
+    powerStep(powerStep_)
+{
+    angleCount = static_cast<int>(std::floor((kMaxAngle - kMinAngle) / angleStep)) + 1;
+    powerCount = static_cast<int>(std::floor((kMaxPower - kMinPower) / powerStep)) + 1;
+}
+
+Shot CpuPlayer::shotAt(std::size_t index) const {
+    int a = static_cast<int>(index) / powerCount;
+    int p = static_cast<int>(index) % powerCount;
+    return Shot{kMinAngle + a * angleStep, kMinPower + p * powerStep};
+}
+
+// Compara los bloques actuales con los de la última vez e invalida solo las
+// entradas afectadas. La trayectoria de un tiro depende de un bloque solo
+// si chocó contra él; si además lo destruyó en el camino, el punto donde lo
+// rompe depende de la resistencia que le quedaba.
+void CpuPlayer::syncTable(Table& t, const GameSimulation& sim) {
+    std::size_t n = sim.blocks.size();
+    std::size_t total = static_cast<std::size_t>(angleCount) * powerCount;
+
+    bool reset = t.entries.size() != total || t.resistance.size() != n ||
+                 t.damageFactor != sim.damageFactor ||
+                 t.restitution != sim.restitutionInfra;
+
+    // Deshacer un tiro devuelve bloques destruidos o resistencia perdida. Los
+    // tiros que pasaban por el hueco nunca tocaron ese bloque, así que no se
+    // pueden invalidar por máscara: se rehace la tabla entera.
+    for (std::size_t b = 0; !reset && b < n; ++b) {
+        reset = (t.destroyed[b] && !sim.blocks[b].destroyed) ||
+                sim.blocks[b].resistance > t.resistance[b];
+    }
+    // Las máscaras solo cubren los primeros 32 bloques: con más, cualquier
+    // cambio rehace la tabla
+    for (std::size_t b = 0; !reset && n > 32 && b < n; ++b) {
+        reset = sim.blocks[b].destroyed != t.destroyed[b] ||
+                sim.blocks[b].resistance != t.resistance[b];
+    }
+    if (reset) {
+        t.entries.assign(total, Entry());
+        t.pending = total;
+        t.cursor = 0;
+        t.damageFactor = sim.damageFactor;
+        t.restitution = sim.restitutionInfra;
+    } else {
+        std::uint32_t newlyDestroyed = 0;
+        std::uint32_t damaged = 0;
+        for (std::size_t b = 0; b < n && b < 32; ++b) {
+            if (sim.blocks[b].destroyed != t.destroyed[b]) {
+                newlyDestroyed |= 1u << b;
+            } else if (sim.blocks[b].resistance != t.resistance[b]) {
+                damaged |= 1u << b;
+            }
+        }
+        if (newlyDestroyed != 0 || damaged != 0) {
+            for (Entry& e : t.entries) {
+                if (!e.valid) continue;
+                if ((e.touched & newlyDestroyed) || (e.breaks & damaged)) {
+                    e.valid = false;
+                    ++t.pending;
+                    continue;
+                }
+                // Con menos resistencia, un tiro que antes no rompía el bloque
+                // ahora puede romperlo y seguir de largo
+                for (std::size_t b = 0; b < n && b < 32; ++b) {
+                    if ((e.touched & (1u << b)) && (damaged & (1u << b)) &&
+                        sim.blocks[b].resistance <= e.damage[b]) {
+                        e.valid = false;
+                        ++t.pending;
+                        break;
+                    }
+                }
+            }
+            if (t.pending > 0) t.cursor = 0;
+        }
+    }
+
+    t.resistance.resize(n);
+    t.destroyed.resize(n);
+    for (std::size_t b = 0; b < n; ++b) {
+        t.resistance[b] = sim.blocks[b].resistance;
+        t.destroyed[b] = sim.blocks[b].destroyed;
+    }
+}
+
+long long CpuPlayer::simulate(const GameSimulation& sim, GameSimulation& trial,
+                              PlayerSide side, std::size_t index, Entry& e) {
+    trial.restore(start);
+    trial.currentTurn = side;
+    PlayerSide shooter = side;
+    Shot s = shotAt(index);
+    fireShot(trial, s.angleDeg, s.power);
+
+    long long steps = 0;
+    while (trial.projectileActive && !trial.gameOver) {
+        trial.update();
+        ++steps;
+    }
+
+    std::size_t n = sim.blocks.size();
+    e = Entry();
+    e.valid = true;
+    e.winsGame = trial.gameOver && trial.winner == shooter;
+    e.losesGame = trial.gameOver && trial.winner != shooter;
+    e.damage.assign(n, 0.0);
+    // Un roce sin daño también cambia la trayectoria
+    e.touched = trial.touchedBlocks;
+    for (std::size_t b = 0; b < n; ++b) {
+        const RectBlock& before = sim.blocks[b];
+        const RectBlock& after = trial.blocks[b];
+        double d = before.resistance - after.resistance;
+        if (d <= 0.0) continue;
+        e.damage[b] = d;
+        if (b < 32 && after.destroyed && !before.destroyed) e.breaks |= 1u << b;
+        if (before.owner == shooter) e.ownDamage += d;
+        else e.enemyDamage += d;
+    }
+    ++simulatedShots;
+    return steps;
+}
+
+bool CpuPlayer::think(const GameSimulation& sim, PlayerSide side,
+                      long long stepBudget) {
+    if (sim.gameOver || sim.projectileActive) return false;
+
+    Table& t = tableFor(side);
+    syncTable(t, sim);
+
+    if (t.pending == 0) return true;
+
+    // Una sola copia por llamada; entre tiro y tiro basta con restore()
+    GameSimulation trial = sim;
+    sim.save(start);
+
+    long long spent = 0;
+    while (t.pending > 0 && spent < stepBudget) {
+        while (t.entries[t.cursor].valid) ++t.cursor;
+        spent += simulate(sim, trial, side, t.cursor, t.entries[t.cursor]);
+        --t.pending;
+        ++t.cursor;
+    }
+    return t.pending == 0;
+}
+
+Shot CpuPlayer::chooseShot(const GameSimulation& sim) {
+    while (!think(sim, sim.currentTurn, 1000000)) {
+        if (sim.gameOver || sim.projectileActive) break;
+    }
+    return bestShot(sim);
+}
+
+// Primero un tiro que gane; si no hay, el que más daño neto hace sin
+// pegarle al propio rival. Con empates gana el primero de la grilla.
+Shot CpuPlayer::bestShot(const GameSimulation& sim) const {
+    const Table& t = tableFor(sim.currentTurn);
+
+    std::size_t best = t.entries.size();
+    double bestScore = 0.0;
+    for (std::size_t i = 0; i < t.entries.size(); ++i) {
+        const Entry& e = t.entries[i];
+        if (!e.valid || e.losesGame) continue;
+        double score = e.winsGame ? 1e9 : e.enemyDamage - e.ownDamage;
+        if (best == t.entries.size() || score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    if (best == t.entries.size()) {
+        return Shot{sim.getCurrentAngleDeg(), sim.getCurrentPower()};
+    }
+    return shotAt(best);
+}
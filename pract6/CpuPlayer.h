@@ -0,0 +1,78 @@
+#ifndef CPUPLAYER_H
+#define CPUPLAYER_H
+
+#include <cstdint>
+#include <vector>
+#include "GameSimulation.h"
+#include "Player.h"
+
+// Oponente de la computadora. Simula cada tiro de una grilla de (ángulo,
+// potencia) dentro de los límites de changeAngle/changePower y elige el
+// mejor. Los resultados quedan en una tabla por lado: cuando cambia un
+// bloque solo se vuelven a simular los tiros que pasaban por él.
+//
+// think() avanza la tabla con un presupuesto de pasos de simulación, para
+// repartir el cálculo entre varios cuadros sin trabar la interfaz. Se puede
+// llamar también durante el turno del otro jugador: después de su tiro solo
+// queda recalcular lo que cambió.
+class CpuPlayer : public Player {
+public:
+    // Grilla por defecto: los mismos pasos que las flechas del teclado
+    explicit CpuPlayer(double angleStep = 2.0, double powerStep = 5.0);
+
+    // Simula tiros pendientes del lado 'side' hasta gastar stepBudget
+    // llamadas a update(). Devuelve true si la tabla quedó completa y ya se
+    // puede elegir. No hace nada con un proyectil en vuelo.
+    bool think(const GameSimulation& sim, PlayerSide side, long long stepBudget);
+
+    // Completa la tabla sin límite y devuelve el mejor tiro
+    Shot chooseShot(const GameSimulation& sim) override;
+
+    // Mejor tiro con lo que ya está calculado
+    Shot bestShot(const GameSimulation& sim) const;
+
+    // Estadísticas: tiros simulados desde el principio
+    long long simulatedShots;
+
+private:
+    // Resultado de un tiro de la grilla
+    struct Entry {
+        bool valid = false;
+        bool winsGame = false;    // le pega al rival contrario
+        bool losesGame = false;   // le pega al propio
+        double enemyDamage = 0.0;
+        double ownDamage = 0.0;
+        std::uint32_t touched = 0;   // bloques contra los que chocó (bits)
+        std::uint32_t breaks = 0;    // bloques que destruyó
+        std::vector<double> damage;  // daño por bloque
+    };
+
+    // Tabla de un lado y el estado de los bloques con que se calculó
+    struct Table {
+        std::vector<Entry> entries;
+        std::vector<double> resistance;
+        std::vector<bool> destroyed;
+        std::size_t pending = 0;     // entradas sin calcular
+        std::size_t cursor = 0;      // próxima a revisar
+        double damageFactor = 0.0;
+        double restitution = 0.0;
+    };
+
+    double angleStep;
+    double powerStep;
+    int angleCount;
+    int powerCount;
+    Table tables[2];
+
+    Table& tableFor(PlayerSide side) { return tables[side == PlayerSide::Left ? 0 : 1]; }
+    const Table& tableFor(PlayerSide side) const { return tables[side == PlayerSide::Left ? 0 : 1]; }
+
+    Shot shotAt(std::size_t index) const;
+    void syncTable(Table& t, const GameSimulation& sim);
+    // Cada tiro se prueba sobre 'trial' después de volverlo a 'start'
+    GameSnapshot start;
+    long long simulate(const GameSimulation& sim, GameSimulation& trial,
+                       PlayerSide side, std::size_t index, Entry& e);
+};
+
+#endif // CPUPLAYER_H
@@ -2,7 +2,8 @@
 #include <algorithm>
 #include <cmath>
 
-GameSimulation::GameSimulation(double width, double height)
+GameSimulation::GameSimulation(double width, double height,
+                               const LevelLayout& layout)
     : worldWidth(width),
     worldHeight(height),
     dt(0.016),
@@ -30,25 +31,29 @@ GameSimulation::GameSimulation(double width, double height)
     gameOver(false),
     winner(PlayerSide::Left),
     shotTime(0.0),
-    maxShotTime(8.0)        // tiempo proyectil en scena
+    maxShotTime(8.0),       // tiempo proyectil en scena
+    touchedBlocks(0),
+    contactBlock(-1),
+    contactNormal(),
+    contactSpeed(0.0)
 {
 
-    double buildingWidth = 160.0;
-    double topHeight     = 40.0;
-    double colHeight     = 120.0;
+    double buildingWidth = layout.buildingWidth;
+    double topHeight     = layout.topHeight;
+    double colHeight     = layout.colHeight;
     double colWidth      = buildingWidth / 3.0;
     double baseY         = 0.0;
 
-    double leftCenterX  = 200.0;
-    double rightCenterX = worldWidth - 200.0;
+    double leftCenterX  = layout.buildingOffset;
+    double rightCenterX = worldWidth - layout.buildingOffset;
 
-    // Bloques superiores (resistencia 100)
+    // Bloques superiores
     RectBlock leftTop(
         leftCenterX - buildingWidth / 2.0,
         baseY + colHeight,
         buildingWidth,
         topHeight,
-        100.0,
+        layout.topResistance,
         PlayerSide::Left
         );
     RectBlock rightTop(
@@ -56,17 +61,17 @@ GameSimulation::GameSimulation(double width, double height)
         baseY + colHeight,
         buildingWidth,
         topHeight,
-        100.0,
+        layout.topResistance,
         PlayerSide::Right
         );
 
-    // Columnas laterales (resistencia 200)
+    // Columnas laterales
     RectBlock leftColL(
         leftCenterX - buildingWidth / 2.0,
         baseY,
         colWidth,
         colHeight,
-        200.0,
+        layout.colResistance,
         PlayerSide::Left
         );
     RectBlock leftColR(
@@ -74,7 +79,7 @@ GameSimulation::GameSimulation(double width, double height)
         baseY,
         colWidth,
         colHeight,
-        200.0,
+        layout.colResistance,
         PlayerSide::Left
         );
 
@@ -83,7 +88,7 @@ GameSimulation::GameSimulation(double width, double height)
         baseY,
         colWidth,
         colHeight,
-        200.0,
+        layout.colResistance,
         PlayerSide::Right
         );
     RectBlock rightColR(
@@ -91,7 +96,7 @@ GameSimulation::GameSimulation(double width, double height)
         baseY,
         colWidth,
         colHeight,
-        200.0,
+        layout.colResistance,
         PlayerSide::Right
         );
 
@@ -101,6 +106,7 @@ GameSimulation::GameSimulation(double width, double height)
     blocks.push_back(rightTop);
     blocks.push_back(rightColL);
     blocks.push_back(rightColR);
+    initialBlocks = blocks;
 
     // Rivales: rectángulo central (sin resistencia propia: se maneja con rivalHealth)
     double rivalWidth  = colWidth;
@@ -131,13 +137,10 @@ void GameSimulation::update() {
 
     shotTime += dt;
 
-    // Actualizar velocidad por gravedad y posición
+    // Actualizar velocidad por gravedad y avanzar hasta el final del paso
+    // resolviendo los choques en el instante exacto en que ocurren
     projectile.velocity.y += gravity * dt;
-    projectile.update(dt);
-
-    handleProjectileWallCollisions();
-    handleProjectileInfraCollisions();
-    handleProjectileRivalCollisions();
+    advanceProjectile(dt);
 
     // Fin del disparo por tiempo o velocidad muy baja
     double speed = std::sqrt(projectile.velocity.x * projectile.velocity.x +
@@ -174,6 +177,8 @@ void GameSimulation::fireCurrentPlayer() {
 
     projectileActive = true;
     shotTime = 0.0;
+    touchedBlocks = 0;
+    contactBlock = -1;
 }
 
 void GameSimulation::changeAngle(double deltaDeg) {
@@ -198,142 +203,323 @@ double GameSimulation::getCurrentPower() const {
     return (currentTurn == PlayerSide::Left) ? leftPower : rightPower;
 }
 
-// Intersección círculo-rectángulo (sin normal)
-bool GameSimulation::circleIntersectsRect(const Particle& p, const RectBlock& r) const {
-    double closestX = std::max(r.x, std::min(p.position.x, r.x + r.width));
-    double closestY = std::max(r.y, std::min(p.position.y, r.y + r.height));
-
-    double dx = p.position.x - closestX;
-    double dy = p.position.y - closestY;
-    double dist2 = dx*dx + dy*dy;
-
-    return dist2 <= p.radius * p.radius;
+void GameSimulation::save(GameSnapshot& out) const {
+    out.currentTurn = currentTurn;
+    out.projectileActive = projectileActive;
+    out.gameOver = gameOver;
+    out.winner = winner;
+    out.projectilePosition = projectile.position;
+    out.projectileVelocity = projectile.velocity;
+    out.leftAngleDeg = leftAngleDeg;
+    out.rightAngleDeg = rightAngleDeg;
+    out.leftPower = leftPower;
+    out.rightPower = rightPower;
+    out.leftScore = leftScore;
+    out.rightScore = rightScore;
+    out.rivalHealthLeft = rivalHealthLeft;
+    out.rivalHealthRight = rivalHealthRight;
+    out.shotTime = shotTime;
+    out.touchedBlocks = touchedBlocks;
+    out.contactBlock = contactBlock;
+    out.contactNormal = contactNormal;
+    out.contactSpeed = contactSpeed;
+
+    out.blocks.clear();
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        const RectBlock& b = blocks[i];
+        const RectBlock& initial = initialBlocks[i];
+        if (b.destroyed != initial.destroyed || b.resistance != initial.resistance) {
+            out.blocks.push_back({static_cast<std::uint16_t>(i),
+                                  b.destroyed, b.resistance});
+        }
+    }
 }
 
-// aproximacion de devolucion de la normal
-bool GameSimulation::circleIntersectsRectWithNormal(const Particle& p,
-                                                    const RectBlock& r,
-                                                    Vec2& outNormal) const {
-    double closestX = std::max(r.x, std::min(p.position.x, r.x + r.width));
-    double closestY = std::max(r.y, std::min(p.position.y, r.y + r.height));
+GameSnapshot GameSimulation::save() const {
+    GameSnapshot s;
+    save(s);
+    return s;
+}
 
-    double dx = p.position.x - closestX;
-    double dy = p.position.y - closestY;
-    double dist2 = dx*dx + dy*dy;
+void GameSimulation::restore(const GameSnapshot& s) {
+    currentTurn = s.currentTurn;
+    projectileActive = s.projectileActive;
+    gameOver = s.gameOver;
+    winner = s.winner;
+    leftAngleDeg = s.leftAngleDeg;
+    rightAngleDeg = s.rightAngleDeg;
+    leftPower = s.leftPower;
+    rightPower = s.rightPower;
+    leftScore = s.leftScore;
+    rightScore = s.rightScore;
+    rivalHealthLeft = s.rivalHealthLeft;
+    rivalHealthRight = s.rivalHealthRight;
+    shotTime = s.shotTime;
+    touchedBlocks = s.touchedBlocks;
+    contactBlock = s.contactBlock;
+    contactNormal = s.contactNormal;
+    contactSpeed = s.contactSpeed;
+
+    projectile.position = s.projectilePosition;
+    projectile.velocity = s.projectileVelocity;
+    projectile.active = s.projectileActive;
+    if (s.projectileActive) {
+        projectile.id = 0;
+        projectile.mass = projectileMass;
+        projectile.radius = projectileRadius;
+    }
 
-    if (dist2 > p.radius * p.radius) {
-        return false;
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i].resistance = initialBlocks[i].resistance;
+        blocks[i].destroyed = initialBlocks[i].destroyed;
+    }
+    for (const BlockDelta& d : s.blocks) {
+        blocks[d.index].resistance = d.resistance;
+        blocks[d.index].destroyed = d.destroyed;
     }
+}
 
-    // Si entra exactamente por un vertice, usamos vector radial
-    if (dist2 > 0.0) {
-        Vec2 n(dx, dy);
-        outNormal = n.normalized();
+namespace {
+
+// Primer instante t en [0, maxT] en que un círculo de radio r que parte de
+// p con velocidad v toca el círculo de centro c (una esquina redondeada).
+// Si ya lo toca y se está acercando, el contacto es en t = 0.
+bool sweepCircleCorner(const Vec2& p, const Vec2& v, double r,
+                       const Vec2& c, double maxT, double& t, Vec2& n) {
+    Vec2 f = p - c;
+    double a = v.dot(v);
+    double b = f.dot(v);
+    double cc = f.dot(f) - r * r;
+    if (cc <= 0.0) {
+        if (b >= 0.0) return false;   // se está alejando
+        t = 0.0;
+        n = f.normalized();
         return true;
     }
-
-    // Si estamos pegados al borde, elegimos la cara más cercana
-    double leftDist   = std::abs(p.position.x - r.x);
-    double rightDist  = std::abs(p.position.x - (r.x + r.width));
-    double bottomDist = std::abs(p.position.y - r.y);
-    double topDist    = std::abs(p.position.y - (r.y + r.height));
-
-    double minDist = std::min(std::min(leftDist, rightDist),
-                              std::min(bottomDist, topDist));
-
-    if (minDist == leftDist)      outNormal = Vec2(-1.0, 0.0);
-    else if (minDist == rightDist) outNormal = Vec2(1.0, 0.0);
-    else if (minDist == bottomDist) outNormal = Vec2(0.0, -1.0);
-    else                           outNormal = Vec2(0.0, 1.0);
-
+    if (b >= 0.0 || a == 0.0) return false;
+    double disc = b * b - a * cc;
+    if (disc < 0.0) return false;
+    t = (-b - std::sqrt(disc)) / a;
+    if (t > maxT) return false;
+    n = (f + v * t).normalized();
     return true;
 }
 
-// Colisiones del proyectil con las paredes de la caja (perfectamente elásticas)
-void GameSimulation::handleProjectileWallCollisions() {
-    if (!projectileActive) return;
-
-    bool collided = false;
-
-    // LEFT / RIGHT
-    if (projectile.position.x - projectile.radius < 0.0) {
-        projectile.position.x = projectile.radius;
-        projectile.velocity.x = -projectile.velocity.x * restitutionWalls;
-        collided = true;
-    } else if (projectile.position.x + projectile.radius > worldWidth) {
-        projectile.position.x = worldWidth - projectile.radius;
-        projectile.velocity.x = -projectile.velocity.x * restitutionWalls;
-        collided = true;
+} // namespace
+
+// Tiempo de impacto de un círculo que se mueve en línea recta contra un
+// rectángulo: es un rayo contra el rectángulo agrandado en r con las
+// esquinas redondeadas. Solo cuenta si el círculo se acerca a la cara (o
+// esquina) que toca, así un contacto ya resuelto no se vuelve a detectar.
+bool GameSimulation::sweepCircleRect(const Vec2& p, const Vec2& v, double r,
+                                     const RectBlock& b, double maxT,
+                                     double& t, Vec2& n) const {
+    double minX = b.x - r, maxX = b.x + b.width + r;
+    double minY = b.y - r, maxY = b.y + b.height + r;
+
+    // Método de las franjas contra el rectángulo agrandado
+    double tEnter = -1e300, tExit = 1e300;
+    int enterAxis = -1;
+    const double pos[2] = {p.x, p.y};
+    const double vel[2] = {v.x, v.y};
+    const double lo[2] = {minX, minY};
+    const double hi[2] = {maxX, maxY};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (vel[axis] == 0.0) {
+            if (pos[axis] < lo[axis] || pos[axis] > hi[axis]) return false;
+            continue;
+        }
+        double t1 = (lo[axis] - pos[axis]) / vel[axis];
+        double t2 = (hi[axis] - pos[axis]) / vel[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tEnter) {
+            tEnter = t1;
+            enterAxis = axis;
+        }
+        tExit = std::min(tExit, t2);
+    }
+    if (tEnter > tExit || tExit < 0.0 || tEnter > maxT) return false;
+
+    // Punto de referencia: donde entra al rectángulo agrandado, o donde
+    // está ahora si ya arrancó adentro
+    double tRef = std::max(tEnter, 0.0);
+    Vec2 q = p + v * tRef;
+    bool outX = q.x < b.x || q.x > b.x + b.width;
+    bool outY = q.y < b.y || q.y > b.y + b.height;
+
+    // En la zona de una esquina el borde es un arco
+    if (outX && outY) {
+        Vec2 corner(q.x < b.x ? b.x : b.x + b.width,
+                    q.y < b.y ? b.y : b.y + b.height);
+        return sweepCircleCorner(p, v, r, corner, maxT, t, n);
     }
 
-    // FLOOR / CEILING
-    if (projectile.position.y - projectile.radius < 0.0) {
-        projectile.position.y = projectile.radius;
-        projectile.velocity.y = -projectile.velocity.y * restitutionWalls;
-        collided = true;
-    } else if (projectile.position.y + projectile.radius > worldHeight) {
-        projectile.position.y = worldHeight - projectile.radius;
-        projectile.velocity.y = -projectile.velocity.y * restitutionWalls;
-        collided = true;
+    if (tEnter >= 0.0) {
+        t = tEnter;
+        n = (enterAxis == 0) ? Vec2(v.x > 0.0 ? -1.0 : 1.0, 0.0)
+                             : Vec2(0.0, v.y > 0.0 ? -1.0 : 1.0);
+        return true;
     }
 
-    if (collided) {
-        // colisión elástica: solo invertimos la componente normal,
-        // ya está hecho arriba con restitutionWalls = 1.0
+    // Ya se superpone con una cara: normal hacia la cara más cercana
+    double leftDist   = p.x - b.x;
+    double rightDist  = b.x + b.width - p.x;
+    double bottomDist = p.y - b.y;
+    double topDist    = b.y + b.height - p.y;
+    if (outX) n = Vec2(p.x < b.x ? -1.0 : 1.0, 0.0);
+    else if (outY) n = Vec2(0.0, p.y < b.y ? -1.0 : 1.0);
+    else {
+        double minDist = std::min(std::min(leftDist, rightDist),
+                                  std::min(bottomDist, topDist));
+        if (minDist == leftDist)        n = Vec2(-1.0, 0.0);
+        else if (minDist == rightDist)  n = Vec2(1.0, 0.0);
+        else if (minDist == bottomDist) n = Vec2(0.0, -1.0);
+        else                            n = Vec2(0.0, 1.0);
     }
+    if (v.dot(n) >= 0.0) return false;
+    t = 0.0;
+    return true;
 }
 
-// Colisiones con infraestructura (inelásticas + daño)
-void GameSimulation::handleProjectileInfraCollisions() {
-    if (!projectileActive) return;
-
-    for (RectBlock& b : blocks) {
-        if (b.destroyed || b.resistance <= 0.0)
-            continue;
-
-        Vec2 normal;
-        if (!circleIntersectsRectWithNormal(projectile, b, normal))
-            continue;
+// Primer contacto del proyectil en los próximos maxT segundos
+bool GameSimulation::findFirstContact(double maxT, Contact& c) const {
+    const Vec2& p = projectile.position;
+    const Vec2& v = projectile.velocity;
+    double r = projectile.radius;
+    bool found = false;
+    c.t = maxT;
+
+    double t;
+    Vec2 n;
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        const RectBlock& b = blocks[i];
+        if (b.destroyed || b.resistance <= 0.0) continue;
+        if (sweepCircleRect(p, v, r, b, c.t, t, n) && (!found || t < c.t)) {
+            c = Contact{t, n, ContactKind::Block, static_cast<int>(i)};
+            found = true;
+        }
+    }
+    if (sweepCircleRect(p, v, r, leftRival, c.t, t, n) && (!found || t < c.t)) {
+        c = Contact{t, n, ContactKind::Rival, 0};
+        found = true;
+    }
+    if (sweepCircleRect(p, v, r, rightRival, c.t, t, n) && (!found || t < c.t)) {
+        c = Contact{t, n, ContactKind::Rival, 1};
+        found = true;
+    }
 
-        // Cálculo de daño: factor * masa * |v|
-        double speed = std::sqrt(projectile.velocity.x * projectile.velocity.x +
-                                 projectile.velocity.y * projectile.velocity.y);
-        double damage = damageFactor * projectile.mass * speed;
+    // Paredes de la caja: planos, el contacto es cuando el borde del
+    // círculo llega al plano (t = 0 si ya lo pasó)
+    auto wall = [&](double velocity, double distance, const Vec2& normal) {
+        if (velocity >= 0.0) return;
+        double tw = std::max(0.0, distance / -velocity);
+        if (tw <= c.t && (!found || tw < c.t)) {
+            c = Contact{tw, normal, ContactKind::Wall, 0};
+            found = true;
+        }
+    };
+    wall(v.x,  p.x - r,                Vec2(1.0, 0.0));
+    wall(-v.x, worldWidth - r - p.x,   Vec2(-1.0, 0.0));
+    wall(v.y,  p.y - r,                Vec2(0.0, 1.0));
+    wall(-v.y, worldHeight - r - p.y,  Vec2(0.0, -1.0));
 
+    return found;
+}
 
-        b.resistance -= damage;
-        if (b.resistance <= 0.0) {
-            b.destroyed = true;
+// Mueve el proyectil dt segundos en línea recta resolviendo los contactos
+// en orden de tiempo. Cada contacto se resuelve una sola vez: después del
+// rebote el proyectil se aleja de esa cara y deja de detectarse.
+void GameSimulation::advanceProjectile(double dt) {
+    double remaining = dt;
+    for (int i = 0; i < kMaxContactsPerStep && projectileActive; ++i) {
+        Contact c;
+        if (!findFirstContact(remaining, c)) break;
+
+        projectile.update(c.t);
+        remaining -= c.t;
+
+        if (c.kind != ContactKind::Block) contactBlock = -1;
+
+        switch (c.kind) {
+        case ContactKind::Wall:
+            resolveWallContact(c.normal);
+            break;
+        case ContactKind::Block:
+            resolveInfraContact(static_cast<std::size_t>(c.index), c.normal);
+            break;
+        case ContactKind::Rival:
+            resolveRivalContact(c.index == 0 ? PlayerSide::Left : PlayerSide::Right);
+            break;
         }
+    }
+    if (projectileActive) projectile.update(remaining);
+}
 
-        // Rebote inelástico: aplicamos e a la componente normal
-        Vec2 v = projectile.velocity;
-        double v_n_scalar = v.dot(normal);
-        Vec2 v_n = normal * v_n_scalar;
-        Vec2 v_t = v - v_n;
+// Colisión con las paredes de la caja (perfectamente elástica)
+void GameSimulation::resolveWallContact(const Vec2& normal) {
+    double r = projectile.radius;
 
-        Vec2 v_n_prime = normal * (-restitutionInfra * v_n_scalar);
-        projectile.velocity = v_n_prime + v_t;
+    // Si ya había pasado la pared (t = 0), lo dejamos justo en el borde
+    if (normal.x > 0.0) projectile.position.x = std::max(projectile.position.x, r);
+    if (normal.x < 0.0) projectile.position.x = std::min(projectile.position.x, worldWidth - r);
+    if (normal.y > 0.0) projectile.position.y = std::max(projectile.position.y, r);
+    if (normal.y < 0.0) projectile.position.y = std::min(projectile.position.y, worldHeight - r);
 
-        // Pequeña corrección de posición hacia afuera del bloque
-        projectile.position += normal * (projectile.radius * 0.2);
+    if (normal.x != 0.0) projectile.velocity.x = -projectile.velocity.x * restitutionWalls;
+    else                 projectile.velocity.y = -projectile.velocity.y * restitutionWalls;
+}
 
-        // Permitimos que siga volando y pueda golpear más cosas
+// Colisión con infraestructura (inelástica + daño)
+void GameSimulation::resolveInfraContact(std::size_t index, const Vec2& normal) {
+    RectBlock& b = blocks[index];
+    if (index < 32) touchedBlocks |= 1u << index;
+
+    Vec2 v = projectile.velocity;
+    double v_n_scalar = v.dot(normal);
+    Vec2 v_t = v - normal * v_n_scalar;
+    double approach = -v_n_scalar;
+
+    // De vuelta a la misma cara sin tocar otra cosa: en vuelo libre no puede
+    // llegar más rápido de lo que salió. Lo que sobra es la gravedad sumada
+    // de a un paso entero, así que no depende de dt.
+    bool sameFace = static_cast<int>(index) == contactBlock &&
+                    normal.dot(contactNormal) > 0.99;
+    if (sameFace) approach = std::min(approach, contactSpeed);
+
+    contactBlock = static_cast<int>(index);
+    contactNormal = normal;
+
+    // Apoyado sobre el bloque: no es un impacto, solo se anula la
+    // componente normal
+    if (sameFace && approach <= kRestingSpeed) {
+        projectile.velocity = v_t;
+        contactSpeed = 0.0;
+        return;
     }
-}
 
-// Colisión contra el representante del rival
-void GameSimulation::handleProjectileRivalCollisions() {
-    if (!projectileActive) return;
+    // Cálculo de daño: factor * masa * |v|
+    double speed = std::sqrt(v_t.dot(v_t) + approach * approach);
+    double damage = damageFactor * projectile.mass * speed;
 
-    bool hitLeft  = circleIntersectsRect(projectile, leftRival);
-    bool hitRight = circleIntersectsRect(projectile, rightRival);
+    b.resistance -= damage;
+    if (b.resistance <= 0.0) {
+        b.destroyed = true;
+    }
+
+    // Rebote inelástico: aplicamos e a la componente normal. Si sale muy
+    // lento queda apoyado (si no, rebotaría sin fin cada vez más bajo)
+    contactSpeed = restitutionInfra * approach;
+    if (contactSpeed <= kRestingSpeed) contactSpeed = 0.0;
+    projectile.velocity = normal * contactSpeed + v_t;
 
-    if (!hitLeft && !hitRight) return;
+    // Permitimos que siga volando y pueda golpear más cosas
+}
 
+// Colisión contra el representante del rival
+void GameSimulation::resolveRivalContact(PlayerSide side) {
     // hit del muñecco
-    if (hitLeft)  rivalHealthLeft  -= 100.0;
-    if (hitRight) rivalHealthRight -= 100.0;
+    if (side == PlayerSide::Left) rivalHealthLeft  -= 100.0;
+    else                          rivalHealthRight -= 100.0;
 
     if (rivalHealthLeft <= 0.0) {
         gameOver = true;
@@ -1,6 +1,7 @@
 #ifndef GAMESIMULATION_H
 #define GAMESIMULATION_H
 
+#include <cstdint>
 #include <vector>
 #include "Vec2.h"
 #include "Particle.h"
@@ -27,6 +28,51 @@ struct RectBlock {
         resistance(res_), destroyed(false), owner(own_) {}
 };
 
+// Disposición del nivel: un edificio por lado (techo sobre dos columnas)
+// con el rival entre las columnas. Los valores por defecto son el nivel
+// original.
+struct LevelLayout {
+    double buildingOffset = 200.0;   // distancia del centro del edificio a la pared
+    double buildingWidth  = 160.0;
+    double topHeight      = 40.0;
+    double colHeight      = 120.0;
+    double topResistance  = 100.0;
+    double colResistance  = 200.0;
+};
+
+// Estado de un bloque que difiere del nivel inicial
+struct BlockDelta {
+    std::uint16_t index;
+    bool destroyed;
+    double resistance;
+};
+
+// Foto del estado de una partida: solo lo que cambia durante el juego (la
+// configuración y la geometría quedan en la simulación). Los bloques se
+// guardan como diferencias con el nivel inicial, casi siempre unos pocos.
+struct GameSnapshot {
+    PlayerSide currentTurn = PlayerSide::Left;
+    bool projectileActive = false;
+    bool gameOver = false;
+    PlayerSide winner = PlayerSide::Left;
+    Vec2 projectilePosition;
+    Vec2 projectileVelocity;
+    double leftAngleDeg = 0.0;
+    double rightAngleDeg = 0.0;
+    double leftPower = 0.0;
+    double rightPower = 0.0;
+    double leftScore = 0.0;
+    double rightScore = 0.0;
+    double rivalHealthLeft = 0.0;
+    double rivalHealthRight = 0.0;
+    double shotTime = 0.0;
+    std::uint32_t touchedBlocks = 0;
+    int contactBlock = -1;
+    Vec2 contactNormal;
+    double contactSpeed = 0.0;
+    std::vector<BlockDelta> blocks;
+};
+
 class GameSimulation {
 public:
     // Mundo (la "caja" del escenario)
@@ -61,6 +107,7 @@ public:
 
     // Infraestructura
     std::vector<RectBlock> blocks;
+    std::vector<RectBlock> initialBlocks;   // el nivel recién armado
 
     // Representantes ("Rival")
     RectBlock leftRival;
@@ -75,7 +122,18 @@ public:
     double shotTime;
     double maxShotTime;
 
-    GameSimulation(double width, double height);
+    // Bloques que tocó el disparo actual (bit i = blocks[i], los primeros 32),
+    // aunque no les haya hecho daño
+    std::uint32_t touchedBlocks;
+
+    // Última cara de bloque que tocó el proyectil (-1 si después tocó otra
+    // cosa) y la rapidez normal con la que salió de ella; 0 = quedó apoyado
+    int contactBlock;
+    Vec2 contactNormal;
+    double contactSpeed;
+
+    GameSimulation(double width, double height,
+                   const LevelLayout& layout = LevelLayout());
 
     // Avanza un paso de la simulación (si hay proyectil activo)
     void update();
@@ -90,15 +148,39 @@ public:
     double getCurrentAngleDeg() const;
     double getCurrentPower() const;
 
+    // Guarda / recupera el estado de la partida. save(out) reutiliza la
+    // memoria de 'out', así guardar muchas veces no reserva memoria.
+    void save(GameSnapshot& out) const;
+    GameSnapshot save() const;
+    void restore(const GameSnapshot& s);
+
 private:
-    bool circleIntersectsRect(const Particle& p, const RectBlock& r) const;
-    bool circleIntersectsRectWithNormal(const Particle& p,
-                                        const RectBlock& r,
-                                        Vec2& outNormal) const;
-
-    void handleProjectileWallCollisions();
-    void handleProjectileInfraCollisions();
-    void handleProjectileRivalCollisions();
+    enum class ContactKind { Wall, Block, Rival };
+
+    // Choque del proyectil dentro de un paso: instante, normal de la
+    // superficie y contra qué (índice del bloque, o 0/1 rival izq/der)
+    struct Contact {
+        double t;
+        Vec2 normal;
+        ContactKind kind;
+        int index;
+    };
+
+    // Tope de choques resueltos en un mismo paso (p. ej. en un rincón)
+    static const int kMaxContactsPerStep = 8;
+
+    // Rapidez normal por debajo de la cual el proyectil queda apoyado
+    static constexpr double kRestingSpeed = 5.0;
+
+    bool sweepCircleRect(const Vec2& p, const Vec2& v, double r,
+                         const RectBlock& b, double maxT,
+                         double& t, Vec2& n) const;
+    bool findFirstContact(double maxT, Contact& c) const;
+    void advanceProjectile(double dt);
+
+    void resolveWallContact(const Vec2& normal);
+    void resolveInfraContact(std::size_t index, const Vec2& normal);
+    void resolveRivalContact(PlayerSide side);
     void endShotAndChangeTurn();
 };
 
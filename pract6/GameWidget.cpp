@@ -6,7 +6,7 @@
 
 GameWidget::GameWidget(GameSimulation* sim, QWidget* parent)
     : QWidget(parent),
-    simulation(sim),
+    runner(sim ? new SimulationRunner(sim) : nullptr),
     cannonSprite(":/images/Canon.png"),
     rivalSprite(":/images/rival.png"),
     backgroundSprite(":/images/fondo.jpg")
@@ -33,18 +33,31 @@ GameWidget::GameWidget(GameSimulation* sim, QWidget* parent)
     setFocusPolicy(Qt::StrongFocus);
     connect(&timer, &QTimer::timeout, this, &GameWidget::onTick);
     timer.start(16);
+
+    if (runner) runner->start();
+}
+
+GameWidget::~GameWidget() {
+    // Detener el hilo antes de que se destruya la simulación
+    if (runner) runner->stop();
 }
 
 
+// El paso de la simulación lo da su hilo; acá solo se redibuja, al ritmo
+// que pueda la interfaz
 void GameWidget::onTick() {
-    if (simulation) {
-        simulation->update();
-        update();
-    }
+    update();
 }
 
 void GameWidget::paintEvent(QPaintEvent*) {
-    if (!simulation) return;
+    if (!runner) return;
+
+    // Se dibuja entre los dos últimos pasos publicados: alpha es cuánto del
+    // paso siguiente ya pasó en tiempo real
+    std::shared_ptr<const FrameState> previous;
+    double alpha = 1.0;
+    runner->latest(previous, frame, alpha);
+    const FrameState& f = *frame;
 
     QPainter p(this);
     p.setRenderHint(QPainter::Antialiasing, true);
@@ -59,8 +72,8 @@ void GameWidget::paintEvent(QPaintEvent*) {
     }
 
 
-    double sx = width()  / simulation->worldWidth;
-    double sy = height() / simulation->worldHeight;
+    double sx = width()  / f.worldWidth;
+    double sy = height() / f.worldHeight;
 
     auto toScreenX = [sx](double x) { return x * sx; };
     auto toScreenY = [sy, this](double y) { return height() - y * sy; };
@@ -70,25 +83,28 @@ void GameWidget::paintEvent(QPaintEvent*) {
     p.drawLine(0, toScreenY(0.0), width(), toScreenY(0.0));
 
     // Bloques (infraestructura)
-    for (const RectBlock& b : simulation->blocks) {
+    for (const RectBlock& b : f.blocks) {
         drawRectBlock(p, b, QColor(255, 230, 180), true);
     }
 
     // Rivales (sprites)
-    drawRival(p, simulation->leftRival);
-    drawRival(p, simulation->rightRival);
+    drawRival(p, f.leftRival);
+    drawRival(p, f.rightRival);
 
     // Cañones (sprites)
-    drawCannon(p, simulation->leftCannonPos,
-               simulation->leftAngleDeg, true);
-    drawCannon(p, simulation->rightCannonPos,
-               simulation->rightAngleDeg, false);
-
-    // Proyectil
-    if (simulation->projectileActive && simulation->projectile.active) {
-        double r = simulation->projectile.radius;
-        double cx = toScreenX(simulation->projectile.position.x);
-        double cy = toScreenY(simulation->projectile.position.y);
+    drawCannon(p, f.leftCannonPos, f.leftAngleDeg, true);
+    drawCannon(p, f.rightCannonPos, f.rightAngleDeg, false);
+
+    // Proyectil: interpolado si los dos estados son del mismo disparo
+    if (f.projectileActive) {
+        Vec2 pos = f.projectilePosition;
+        if (previous->projectileActive && previous->shotTime < f.shotTime) {
+            pos = previous->projectilePosition +
+                  (f.projectilePosition - previous->projectilePosition) * alpha;
+        }
+        double r = f.projectileRadius;
+        double cx = toScreenX(pos.x);
+        double cy = toScreenY(pos.y);
         double d  = 2.0 * r * sx;
 
         p.setBrush(Qt::red);
@@ -101,20 +117,24 @@ void GameWidget::paintEvent(QPaintEvent*) {
     p.setFont(QFont("Arial", 10));
 
 
-    QString turnText = (simulation->currentTurn == PlayerSide::Left)
+    QString turnText = (f.currentTurn == PlayerSide::Left)
                            ? "Turno: Jugador 1"
                            : "Turno: Jugador 2";
     p.drawText(width()/2 - 60, 20, turnText);
+    if (f.cpuEnabled) {
+        p.drawText(width() - 190, 20,
+                   f.cpuThinking ? "CPU pensando..." : "Jugador 2: CPU (C)");
+    }
 
     p.drawText(10, 40,
-               QString("Ángulo: %1°").arg(simulation->getCurrentAngleDeg(), 0, 'f', 1));
+               QString("Ángulo: %1°").arg(f.currentAngleDeg, 0, 'f', 1));
     p.drawText(10, 55,
-               QString("Potencia: %1").arg(simulation->getCurrentPower(), 0, 'f', 1));
+               QString("Potencia: %1").arg(f.currentPower, 0, 'f', 1));
 
-    if (simulation->gameOver) {
+    if (f.gameOver) {
         p.setFont(QFont("Arial", 24, QFont::Bold));
         p.setPen(Qt::red);
-        QString msg = (simulation->winner == PlayerSide::Left)
+        QString msg = (f.winner == PlayerSide::Left)
                           ? "GANADOR: JUGADOR 1"
                           : "GANADOR: JUGADOR 2";
         p.drawText(rect(), Qt::AlignCenter, msg);
@@ -125,8 +145,8 @@ void GameWidget::drawRectBlock(QPainter& p, const RectBlock& b,
                                const QColor& color, bool drawResistance) {
     if (b.destroyed || b.resistance <= 0.0) return;
 
-    double sx = width()  / simulation->worldWidth;
-    double sy = height() / simulation->worldHeight;
+    double sx = width()  / frame->worldWidth;
+    double sy = height() / frame->worldHeight;
 
     double x = b.x * sx;
     double y = height() - (b.y + b.height) * sy;
@@ -148,8 +168,8 @@ void GameWidget::drawRectBlock(QPainter& p, const RectBlock& b,
 void GameWidget::drawRival(QPainter& p, const RectBlock& rival) {
     if (rivalSprite.isNull()) return;
 
-    double sx = width()  / simulation->worldWidth;
-    double sy = height() / simulation->worldHeight;
+    double sx = width()  / frame->worldWidth;
+    double sy = height() / frame->worldHeight;
 
     double centerX = (rival.x + rival.width / 2.0) * sx;
     double bottomY = height() - rival.y * sy;
@@ -168,8 +188,8 @@ void GameWidget::drawCannon(QPainter& p, const Vec2& pos,
                             double angleDeg, bool leftSide) {
     if (cannonSprite.isNull()) return;
 
-    double sx = width()  / simulation->worldWidth;
-    double sy = height() / simulation->worldHeight;
+    double sx = width()  / frame->worldWidth;
+    double sy = height() / frame->worldHeight;
 
     double baseX = pos.x * sx;
     double baseY = height() - pos.y * sy;
@@ -205,32 +225,38 @@ void GameWidget::drawCannon(QPainter& p, const Vec2& pos,
 }
 
 
+// Las teclas se mandan como órdenes al hilo de simulación, que decide si
+// valen (partida terminada, turno de la computadora...)
 void GameWidget::keyPressEvent(QKeyEvent* e) {
-    if (!simulation || simulation->gameOver) {
+    if (!runner) {
         QWidget::keyPressEvent(e);
         return;
     }
 
     switch (e->key()) {
     case Qt::Key_Up:
-        simulation->changeAngle(2.0);
+        runner->changeAngle(2.0);
         break;
     case Qt::Key_Down:
-        simulation->changeAngle(-2.0);
+        runner->changeAngle(-2.0);
         break;
     case Qt::Key_Left:
-        simulation->changePower(-5.0);
+        runner->changePower(-5.0);
         break;
     case Qt::Key_Right:
-        simulation->changePower(5.0);
+        runner->changePower(5.0);
         break;
     case Qt::Key_Space:
-        simulation->fireCurrentPlayer();
+        runner->fire();
+        break;
+    case Qt::Key_U:     // vuelve a antes del último tiro
+        runner->undo();
+        break;
+    case Qt::Key_C:     // la computadora toma (o deja) el jugador 2
+        runner->toggleCpu();
         break;
     default:
         QWidget::keyPressEvent(e);
         return;
     }
-
-    update();
 }
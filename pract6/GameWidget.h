@@ -4,12 +4,15 @@
 #include <QWidget>
 #include <QTimer>
 #include <QPixmap>
+#include <memory>
 #include "GameSimulation.h"
+#include "SimulationRunner.h"
 
 class GameWidget : public QWidget {
     Q_OBJECT
 public:
     explicit GameWidget(GameSimulation* sim, QWidget* parent = nullptr);
+    ~GameWidget();
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -19,9 +22,13 @@ private slots:
     void onTick();
 
 private:
-    GameSimulation* simulation;
+    // La simulación corre en su hilo; el timer solo redibuja
+    std::unique_ptr<SimulationRunner> runner;
     QTimer timer;
 
+    // Estado que se está dibujando (válido durante paintEvent)
+    std::shared_ptr<const FrameState> frame;
+
     QPixmap cannonSprite;
     QPixmap rivalSprite;
     QPixmap backgroundSprite;
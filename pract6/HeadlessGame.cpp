@@ -0,0 +1,52 @@
+#include "HeadlessGame.h"
+#include "Player.h"
+
+void fireShot(GameSimulation& sim, double angleDeg, double power) {
+    sim.changeAngle(angleDeg - sim.getCurrentAngleDeg());
+    sim.changePower(power - sim.getCurrentPower());
+    sim.fireCurrentPlayer();
+}
+
+GameResult playGame(GameSimulation& sim, Player& left, Player& right,
+                    int maxShots) {
+    GameResult r;
+
+    // Resistencia inicial de cada lado, para medir el daño al final
+    double initialLeft = 0.0;
+    double initialRight = 0.0;
+    for (const RectBlock& b : sim.blocks) {
+        if (b.owner == PlayerSide::Left) initialLeft += b.resistance;
+        else initialRight += b.resistance;
+    }
+
+    while (!sim.gameOver && r.shots < maxShots) {
+        Player& p = (sim.currentTurn == PlayerSide::Left) ? left : right;
+        Shot s = p.chooseShot(sim);
+        fireShot(sim, s.angleDeg, s.power);
+        ++r.shots;
+
+        while (sim.projectileActive && !sim.gameOver) {
+            sim.update();
+            ++r.steps;
+        }
+    }
+
+    r.finished = sim.gameOver;
+    r.winner = sim.winner;
+
+    double remainingLeft = 0.0;
+    double remainingRight = 0.0;
+    for (const RectBlock& b : sim.blocks) {
+        double rest = b.destroyed ? 0.0 : b.resistance;
+        if (b.owner == PlayerSide::Left) {
+            remainingLeft += rest;
+            if (b.destroyed) ++r.leftBlocksDestroyed;
+        } else {
+            remainingRight += rest;
+            if (b.destroyed) ++r.rightBlocksDestroyed;
+        }
+    }
+    r.leftDamage = initialLeft - remainingLeft;
+    r.rightDamage = initialRight - remainingRight;
+    return r;
+}
@@ -0,0 +1,30 @@
+#ifndef HEADLESSGAME_H
+#define HEADLESSGAME_H
+
+#include "GameSimulation.h"
+
+class Player;
+
+// Resultado de una partida completa jugada sin interfaz
+struct GameResult {
+    bool finished = false;      // false: se alcanzó el límite de tiros (empate)
+    PlayerSide winner = PlayerSide::Left;
+    int shots = 0;
+    long long steps = 0;        // llamadas a update() con proyectil en vuelo
+    double leftDamage = 0.0;    // resistencia que le quitaron a cada edificio
+    double rightDamage = 0.0;
+    int leftBlocksDestroyed = 0;
+    int rightBlocksDestroyed = 0;
+};
+
+// Juega 'sim' hasta que termine o hasta maxShots tiros, lo más rápido que
+// se pueda: cada jugador elige su tiro, se fija con changeAngle/changePower
+// (así se respetan los mismos límites que con el teclado) y se llama a
+// update() hasta que el proyectil se detiene.
+GameResult playGame(GameSimulation& sim, Player& left, Player& right,
+                    int maxShots);
+
+// Apunta el cañón del jugador del turno actual y dispara
+void fireShot(GameSimulation& sim, double angleDeg, double power);
+
+#endif // HEADLESSGAME_H
@@ -0,0 +1,32 @@
+#include "Player.h"
+
+ScriptedPlayer::ScriptedPlayer(const std::vector<Shot>& shots_)
+    : shots(shots_), next(0)
+{
+}
+
+Shot ScriptedPlayer::chooseShot(const GameSimulation&) {
+    if (shots.empty()) return Shot{45.0, 140.0};
+    Shot s = shots[next];
+    next = (next + 1) % shots.size();
+    return s;
+}
+
+RandomPlayer::RandomPlayer(std::uint64_t seed)
+    : engine(seed)
+{
+}
+
+// No usamos std::uniform_real_distribution: cambia entre compiladores y
+// queremos que la misma semilla dé la misma partida en todos lados
+double RandomPlayer::uniform(double a, double b) {
+    double u = static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0);
+    return a + (b - a) * u;
+}
+
+Shot RandomPlayer::chooseShot(const GameSimulation&) {
+    Shot s;
+    s.angleDeg = uniform(5.0, 85.0);
+    s.power = uniform(30.0, 350.0);
+    return s;
+}
@@ -0,0 +1,46 @@
+#ifndef PLAYER_H
+#define PLAYER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class GameSimulation;
+
+// Un tiro: ángulo en grados y potencia, dentro de los límites de
+// changeAngle (5..85) y changePower (30..350)
+struct Shot {
+    double angleDeg;
+    double power;
+};
+
+// Jugador sin teclado: decide el próximo tiro mirando la simulación
+class Player {
+public:
+    virtual ~Player() {}
+    virtual Shot chooseShot(const GameSimulation& sim) = 0;
+};
+
+// Repite una lista fija de tiros en orden
+class ScriptedPlayer : public Player {
+public:
+    explicit ScriptedPlayer(const std::vector<Shot>& shots);
+    Shot chooseShot(const GameSimulation& sim) override;
+
+private:
+    std::vector<Shot> shots;
+    std::size_t next;
+};
+
+// Tiros uniformes al azar en todo el rango permitido
+class RandomPlayer : public Player {
+public:
+    explicit RandomPlayer(std::uint64_t seed);
+    Shot chooseShot(const GameSimulation& sim) override;
+
+private:
+    std::mt19937_64 engine;
+    double uniform(double a, double b);
+};
+
+#endif // PLAYER_H
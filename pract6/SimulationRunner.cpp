@@ -0,0 +1,208 @@
+#include "SimulationRunner.h"
+#include "HeadlessGame.h"
+#include <algorithm>
+
+namespace {
+
+// Pasos de simulación que la computadora puede gastar pensando por vuelta
+// del hilo (unos pocos milisegundos)
+const long long kCpuStepBudget = 40000;
+
+// Si el hilo se atrasa más que esto (p. ej. la máquina estuvo suspendida)
+// se descarta el resto en vez de correr cientos de pasos seguidos
+const double kMaxBacklogSeconds = 0.25;
+
+} // namespace
+
+SimulationRunner::SimulationRunner(GameSimulation* sim)
+    : simulation(sim),
+    cpuEnabled(false),
+    cpuSide(PlayerSide::Right),
+    running(false)
+{
+    publish(true);
+}
+
+SimulationRunner::~SimulationRunner() {
+    stop();
+}
+
+void SimulationRunner::start() {
+    if (running) return;
+    running = true;
+    worker = std::thread(&SimulationRunner::run, this);
+}
+
+void SimulationRunner::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void SimulationRunner::changeAngle(double deltaDeg) { push(CommandKind::ChangeAngle, deltaDeg); }
+void SimulationRunner::changePower(double delta)    { push(CommandKind::ChangePower, delta); }
+void SimulationRunner::fire()      { push(CommandKind::Fire, 0.0); }
+void SimulationRunner::undo()      { push(CommandKind::Undo, 0.0); }
+void SimulationRunner::toggleCpu() { push(CommandKind::ToggleCpu, 0.0); }
+
+void SimulationRunner::push(CommandKind kind, double amount) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        commands.push_back(Command{kind, amount});
+    }
+    wake.notify_all();
+}
+
+void SimulationRunner::latest(std::shared_ptr<const FrameState>& previous,
+                              std::shared_ptr<const FrameState>& current,
+                              double& alpha) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        previous = previousFrame;
+        current = currentFrame;
+    }
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - current->publishedAt).count();
+    alpha = current->stepSeconds > 0.0 ? elapsed / current->stepSeconds : 1.0;
+    alpha = std::min(1.0, std::max(0.0, alpha));
+}
+
+void SimulationRunner::run() {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point last = Clock::now();
+    double accumulator = 0.0;
+
+    while (running) {
+        Clock::time_point now = Clock::now();
+        accumulator += std::chrono::duration<double>(now - last).count();
+        last = now;
+        accumulator = std::min(accumulator, kMaxBacklogSeconds);
+
+        bool changed = applyCommands();
+
+        // La computadora piensa también mientras apunta el otro jugador
+        if (cpuEnabled && !simulation->projectileActive &&
+            cpu.think(*simulation, cpuSide, kCpuStepBudget) && cpuTurn()) {
+            Shot s = cpu.bestShot(*simulation);
+            shoot(s.angleDeg, s.power);
+            changed = true;
+        }
+
+        // Paso fijo: tantos pasos como quepan en el tiempo acumulado
+        double step = simulation->dt;
+        while (accumulator >= step) {
+            simulation->update();
+            accumulator -= step;
+            publish(true);
+            changed = false;
+        }
+        if (changed) publish(false);
+
+        // Dormir hasta el próximo paso o hasta que llegue una orden
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_for(lock, std::chrono::duration<double>(step - accumulator),
+                      [this] { return !commands.empty() || !running; });
+    }
+}
+
+bool SimulationRunner::applyCommands() {
+    std::vector<Command> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.swap(commands);
+    }
+    for (const Command& c : pending) apply(c);
+    return !pending.empty();
+}
+
+void SimulationRunner::apply(const Command& c) {
+    if (c.kind == CommandKind::Undo) {
+        undoLastShot();
+        return;
+    }
+    if (simulation->gameOver) return;
+
+    if (c.kind == CommandKind::ToggleCpu) {
+        cpuEnabled = !cpuEnabled;
+        return;
+    }
+
+    // En el turno de la computadora no se aceptan tiros del teclado
+    if (cpuTurn()) return;
+
+    switch (c.kind) {
+    case CommandKind::ChangeAngle:
+        simulation->changeAngle(c.amount);
+        break;
+    case CommandKind::ChangePower:
+        simulation->changePower(c.amount);
+        break;
+    case CommandKind::Fire:
+        shoot(simulation->getCurrentAngleDeg(), simulation->getCurrentPower());
+        break;
+    default:
+        break;
+    }
+}
+
+bool SimulationRunner::cpuTurn() const {
+    return cpuEnabled && !simulation->gameOver &&
+           simulation->currentTurn == cpuSide;
+}
+
+// Guarda el estado antes de cada tiro, para deshacer
+void SimulationRunner::shoot(double angleDeg, double power) {
+    if (simulation->projectileActive) return;
+    history.push_back(simulation->save());
+    fireShot(*simulation, angleDeg, power);
+}
+
+void SimulationRunner::undoLastShot() {
+    while (!history.empty()) {
+        simulation->restore(history.back());
+        history.pop_back();
+        // Contra la computadora se vuelve hasta el turno del jugador
+        if (!cpuTurn()) break;
+    }
+}
+
+// Con stepped = false solo cambió algo por una orden (ángulo, potencia...):
+// se reemplaza el estado actual sin correr el anterior ni el reloj, para no
+// cortar la interpolación del proyectil.
+void SimulationRunner::publish(bool stepped) {
+    std::shared_ptr<FrameState> f = std::make_shared<FrameState>();
+    const GameSimulation& s = *simulation;
+    f->worldWidth = s.worldWidth;
+    f->worldHeight = s.worldHeight;
+    f->blocks = s.blocks;
+    f->leftRival = s.leftRival;
+    f->rightRival = s.rightRival;
+    f->leftCannonPos = s.leftCannonPos;
+    f->rightCannonPos = s.rightCannonPos;
+    f->leftAngleDeg = s.leftAngleDeg;
+    f->rightAngleDeg = s.rightAngleDeg;
+    f->projectileActive = s.projectileActive && s.projectile.active;
+    f->projectilePosition = s.projectile.position;
+    f->projectileRadius = s.projectile.radius;
+    f->shotTime = s.shotTime;
+    f->currentTurn = s.currentTurn;
+    f->currentAngleDeg = s.getCurrentAngleDeg();
+    f->currentPower = s.getCurrentPower();
+    f->gameOver = s.gameOver;
+    f->winner = s.winner;
+    f->cpuEnabled = cpuEnabled;
+    f->cpuThinking = cpuTurn() && !s.projectileActive;
+    f->stepSeconds = s.dt;
+    f->publishedAt = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stepped || !currentFrame) {
+        previousFrame = currentFrame ? currentFrame : f;
+    } else {
+        f->publishedAt = currentFrame->publishedAt;
+    }
+    currentFrame = f;
+}
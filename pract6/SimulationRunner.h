@@ -0,0 +1,109 @@
+#ifndef SIMULATIONRUNNER_H
+#define SIMULATIONRUNNER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CpuPlayer.h"
+#include "GameSimulation.h"
+
+// Estado inmutable que publica el hilo de simulación para dibujar. Una vez
+// publicado nadie lo modifica, así la interfaz lo lee sin bloquear al hilo.
+struct FrameState {
+    double worldWidth = 0.0;
+    double worldHeight = 0.0;
+
+    std::vector<RectBlock> blocks;
+    RectBlock leftRival;
+    RectBlock rightRival;
+    Vec2 leftCannonPos;
+    Vec2 rightCannonPos;
+    double leftAngleDeg = 0.0;
+    double rightAngleDeg = 0.0;
+
+    bool projectileActive = false;
+    Vec2 projectilePosition;
+    double projectileRadius = 0.0;
+    double shotTime = 0.0;
+
+    PlayerSide currentTurn = PlayerSide::Left;
+    double currentAngleDeg = 0.0;
+    double currentPower = 0.0;
+    bool gameOver = false;
+    PlayerSide winner = PlayerSide::Left;
+
+    bool cpuEnabled = false;
+    bool cpuThinking = false;
+
+    // Cuándo se publicó este paso y cuánto dura, para interpolar
+    std::chrono::steady_clock::time_point publishedAt;
+    double stepSeconds = 0.0;
+};
+
+// Corre la simulación en su propio hilo con paso fijo (sim->dt): acumula el
+// tiempo real transcurrido y da tantos pasos como quepan, sin importar a qué
+// ritmo dibuja la interfaz. Publica los dos últimos estados (doble buffer)
+// y recibe las órdenes del teclado en una cola.
+//
+// Mientras corre, el hilo es el único que toca la simulación.
+class SimulationRunner {
+public:
+    explicit SimulationRunner(GameSimulation* sim);
+    ~SimulationRunner();
+
+    void start();
+    void stop();
+
+    // Órdenes de la interfaz; se aplican en el hilo de simulación
+    void changeAngle(double deltaDeg);
+    void changePower(double delta);
+    void fire();
+    void undo();        // vuelve a antes del último tiro
+    void toggleCpu();   // la computadora toma (o deja) el jugador 2
+
+    // Los dos últimos estados publicados y la fracción (0..1) del paso que
+    // pasó desde que se publicó el último
+    void latest(std::shared_ptr<const FrameState>& previous,
+                std::shared_ptr<const FrameState>& current,
+                double& alpha) const;
+
+private:
+    enum class CommandKind { ChangeAngle, ChangePower, Fire, Undo, ToggleCpu };
+    struct Command {
+        CommandKind kind;
+        double amount;
+    };
+
+    GameSimulation* simulation;
+
+    // Solo los usa el hilo de simulación
+    CpuPlayer cpu;
+    bool cpuEnabled;
+    PlayerSide cpuSide;
+    std::vector<GameSnapshot> history;
+
+    std::thread worker;
+    std::atomic<bool> running;
+
+    // Protege la cola de órdenes y los estados publicados
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Command> commands;
+    std::shared_ptr<const FrameState> previousFrame;
+    std::shared_ptr<const FrameState> currentFrame;
+
+    void run();
+    void push(CommandKind kind, double amount);
+    bool applyCommands();
+    void apply(const Command& c);
+    bool cpuTurn() const;
+    void shoot(double angleDeg, double power);
+    void undoLastShot();
+    void publish(bool stepped);
+};
+
+#endif // SIMULATIONRUNNER_H
@@ -0,0 +1,15 @@
+# Enlace con el núcleo del juego (gamecore/gamecore.pro, biblioteca estática
+# sin Qt). Lo incluyen game/game.pro y tournament/tournament.pro; pract6.pro
+# compila la biblioteca antes que a ellos.
+CONFIG += c++17 thread
+
+INCLUDEPATH += $$PWD
+
+GAMECORE_DIR = $$shadowed($$PWD/gamecore)
+win32:CONFIG(debug, debug|release): GAMECORE_DIR = $$GAMECORE_DIR/debug
+else:win32: GAMECORE_DIR = $$GAMECORE_DIR/release
+
+LIBS += -L$$GAMECORE_DIR -lgamecore
+
+win32-msvc*: PRE_TARGETDEPS += $$GAMECORE_DIR/gamecore.lib
+else: PRE_TARGETDEPS += $$GAMECORE_DIR/libgamecore.a
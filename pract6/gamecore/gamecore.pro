@@ -0,0 +1,27 @@
+# Núcleo del juego sin Qt: la simulación, los jugadores automáticos, el
+# driver de partidas y el hilo de simulación en tiempo real. Se compila
+# una sola vez como biblioteca estática; el juego y el torneo la enlazan
+# con ../gamecore.pri.
+TEMPLATE = lib
+CONFIG += staticlib c++17 thread
+CONFIG -= qt
+
+TARGET = gamecore
+
+SOURCES += \
+        ../CpuPlayer.cpp \
+        ../GameSimulation.cpp \
+        ../HeadlessGame.cpp \
+        ../Particle.cpp \
+        ../Player.cpp \
+        ../SimulationRunner.cpp \
+        ../Vec2.cpp
+
+HEADERS += \
+    ../CpuPlayer.h \
+    ../GameSimulation.h \
+    ../HeadlessGame.h \
+    ../Particle.h \
+    ../Player.h \
+    ../SimulationRunner.h \
+    ../Vec2.h
@@ -13,5 +13,7 @@ MainWindow::MainWindow(QWidget* parent)
 }
 
 MainWindow::~MainWindow() {
+    // El widget detiene el hilo que usa la simulación: va primero
+    delete widget;
     delete simulation;
 }
@@ -1,39 +1,11 @@
-QT       += core gui
+# Proyecto completo: primero el núcleo sin Qt (biblioteca estática) y
+# después el juego con interfaz y el torneo sin interfaz, que lo enlazan
+TEMPLATE = subdirs
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+SUBDIRS = \
+    gamecore \
+    game \
+    tournament
 
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    Box.cpp \
-    GameSimulation.cpp \
-    GameWidget.cpp \
-    Particle.cpp \
-    Vec2.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    obstacle.cpp
-
-HEADERS += \
-    Box.h \
-    GameSimulation.h \
-    GameWidget.h \
-    Particle.h \
-    Vec2.h \
-    mainwindow.h \
-    obstacle.h
-
-FORMS += \
-    mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    images.qrc
+game.depends = gamecore
+tournament.depends = gamecore
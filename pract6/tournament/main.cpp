@@ -0,0 +1,326 @@
+// Torneo sin interfaz: juega partidas completas de GameSimulation lo más
+// rápido que se pueda, repartidas entre todos los núcleos, sobre el producto
+// de las listas de damageFactor, restitutionInfra y niveles.
+//
+// Uso: tournament [--games N] [--threads N] [--damage 0.04,0.08]
+//                 [--restitution 0.4,0.6] [--layouts default,tall,wide,close]
+//                 [--left random|scripted|cpu] [--right random|scripted|cpu]
+//                 [--script 45:140,60:200] [--max-shots N] [--seed S]
+//                 [--out tournament.csv]
+//
+// La partida g de cada configuración usa siempre las mismas semillas, así
+// las configuraciones se comparan sobre las mismas secuencias de tiros. El
+// resultado no depende de la cantidad de hilos.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameSimulation.h"
+#include "HeadlessGame.h"
+#include "CpuPlayer.h"
+#include "Player.h"
+
+namespace {
+
+struct TournamentConfig {
+    long long games = 1000;
+    unsigned threads = 0;                 // 0 = todos los núcleos
+    std::vector<double> damageFactors{0.08};
+    std::vector<double> restitutions{0.6};
+    std::vector<std::string> layouts{"default"};
+    std::string leftKind = "random";
+    std::string rightKind = "random";
+    std::vector<Shot> script{{45.0, 140.0}};
+    int maxShots = 200;
+    std::uint64_t seed = 1;
+    std::string outFile = "tournament.csv";
+};
+
+// Una combinación de parámetros del barrido
+struct Variant {
+    std::string layoutName;
+    LevelLayout layout;
+    double damageFactor;
+    double restitution;
+};
+
+// Sumas de un bloque de partidas
+struct Totals {
+    long long games = 0;
+    long long leftWins = 0;
+    long long rightWins = 0;
+    long long draws = 0;
+    long long shots = 0;
+    long long steps = 0;
+    double leftDamage = 0.0;
+    double rightDamage = 0.0;
+
+    void add(const GameResult& r) {
+        ++games;
+        if (!r.finished) ++draws;
+        else if (r.winner == PlayerSide::Left) ++leftWins;
+        else ++rightWins;
+        shots += r.shots;
+        steps += r.steps;
+        leftDamage += r.leftDamage;
+        rightDamage += r.rightDamage;
+    }
+
+    void add(const Totals& t) {
+        games += t.games;
+        leftWins += t.leftWins;
+        rightWins += t.rightWins;
+        draws += t.draws;
+        shots += t.shots;
+        steps += t.steps;
+        leftDamage += t.leftDamage;
+        rightDamage += t.rightDamage;
+    }
+};
+
+// Partidas por bloque de trabajo; los bloques se suman en orden al final
+const long long kBlockGames = 256;
+
+bool layoutByName(const std::string& name, LevelLayout& out) {
+    LevelLayout l;
+    if (name == "default") {
+    } else if (name == "tall") {        // edificios más altos
+        l.colHeight = 160.0;
+        l.topHeight = 50.0;
+    } else if (name == "wide") {        // techo más ancho que cubre al rival
+        l.buildingWidth = 220.0;
+    } else if (name == "close") {       // edificios más cerca del centro
+        l.buildingOffset = 300.0;
+    } else {
+        return false;
+    }
+    out = l;
+    return true;
+}
+
+template <typename T, typename Parse>
+bool parseList(const std::string& text, std::vector<T>& out, Parse parse) {
+    out.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        T v;
+        if (!parse(item, v)) return false;
+        out.push_back(v);
+    }
+    return !out.empty();
+}
+
+bool parseDouble(const std::string& s, double& v) {
+    char* end = nullptr;
+    v = std::strtod(s.c_str(), &end);
+    return end != s.c_str() && *end == '\0';
+}
+
+bool parseShot(const std::string& s, Shot& shot) {
+    std::size_t colon = s.find(':');
+    if (colon == std::string::npos) return false;
+    return parseDouble(s.substr(0, colon), shot.angleDeg) &&
+           parseDouble(s.substr(colon + 1), shot.power);
+}
+
+bool parseArgs(int argc, char* argv[], TournamentConfig& c) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            return (i + 1 < argc) ? argv[++i] : nullptr;
+        };
+        const char* v = nullptr;
+        if (arg == "--games" && (v = next())) {
+            c.games = std::atoll(v);
+        } else if (arg == "--threads" && (v = next())) {
+            int n = std::atoi(v);
+            if (n <= 0) return false;
+            c.threads = static_cast<unsigned>(n);
+        } else if (arg == "--damage" && (v = next())) {
+            if (!parseList(v, c.damageFactors, parseDouble)) return false;
+        } else if (arg == "--restitution" && (v = next())) {
+            if (!parseList(v, c.restitutions, parseDouble)) return false;
+        } else if (arg == "--layouts" && (v = next())) {
+            auto same = [](const std::string& s, std::string& out) {
+                out = s;
+                return true;
+            };
+            if (!parseList(v, c.layouts, same)) return false;
+        } else if (arg == "--left" && (v = next())) {
+            c.leftKind = v;
+        } else if (arg == "--right" && (v = next())) {
+            c.rightKind = v;
+        } else if (arg == "--script" && (v = next())) {
+            if (!parseList(v, c.script, parseShot)) return false;
+        } else if (arg == "--max-shots" && (v = next())) {
+            c.maxShots = std::atoi(v);
+        } else if (arg == "--seed" && (v = next())) {
+            c.seed = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--out" && (v = next())) {
+            c.outFile = v;
+        } else {
+            return false;
+        }
+    }
+    auto validKind = [](const std::string& k) {
+        return k == "random" || k == "scripted" || k == "cpu";
+    };
+    return c.games > 0 && c.maxShots > 0 &&
+           validKind(c.leftKind) && validKind(c.rightKind);
+}
+
+// splitmix64: semillas independientes para cada partida y jugador
+std::uint64_t mixSeed(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+std::unique_ptr<Player> makePlayer(const TournamentConfig& c,
+                                   const std::string& kind,
+                                   std::uint64_t seed) {
+    if (kind == "scripted") {
+        return std::unique_ptr<Player>(new ScriptedPlayer(c.script));
+    }
+    if (kind == "cpu") {
+        return std::unique_ptr<Player>(new CpuPlayer());
+    }
+    return std::unique_ptr<Player>(new RandomPlayer(seed));
+}
+
+GameResult playOne(const TournamentConfig& c, const Variant& v, long long game) {
+    GameSimulation sim(800.0, 400.0, v.layout);
+    sim.damageFactor = v.damageFactor;
+    sim.restitutionInfra = v.restitution;
+
+    std::uint64_t base = mixSeed(c.seed ^ mixSeed(static_cast<std::uint64_t>(game)));
+    std::unique_ptr<Player> left = makePlayer(c, c.leftKind, mixSeed(base));
+    std::unique_ptr<Player> right = makePlayer(c, c.rightKind, mixSeed(base + 1));
+    return playGame(sim, *left, *right, c.maxShots);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    TournamentConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "uso: tournament [--games N] [--threads N] [--damage a,b]"
+                     " [--restitution a,b] [--layouts default,tall,wide,close]"
+                     " [--left random|scripted|cpu] [--right random|scripted|cpu]"
+                     " [--script ang:pot,...] [--max-shots N] [--seed S]"
+                     " [--out archivo.csv]\n";
+        return 1;
+    }
+
+    std::vector<Variant> variants;
+    for (const std::string& name : config.layouts) {
+        LevelLayout layout;
+        if (!layoutByName(name, layout)) {
+            std::cerr << "nivel desconocido: " << name << "\n";
+            return 1;
+        }
+        for (double d : config.damageFactors) {
+            for (double e : config.restitutions) {
+                variants.push_back({name, layout, d, e});
+            }
+        }
+    }
+
+    unsigned threads = config.threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Trabajo = (variante, bloque de partidas); cada hilo toma el siguiente
+    long long blocksPerVariant = (config.games + kBlockGames - 1) / kBlockGames;
+    long long totalBlocks = blocksPerVariant * static_cast<long long>(variants.size());
+    std::vector<Totals> blockTotals(static_cast<std::size_t>(totalBlocks));
+    // Más hilos que bloques no sirven de nada
+    if (static_cast<long long>(threads) > totalBlocks) {
+        threads = static_cast<unsigned>(std::max(1LL, totalBlocks));
+    }
+    std::atomic<long long> nextBlock(0);
+
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&]() {
+        for (;;) {
+            long long b = nextBlock.fetch_add(1);
+            if (b >= totalBlocks) return;
+            const Variant& v = variants[static_cast<std::size_t>(b / blocksPerVariant)];
+            long long first = (b % blocksPerVariant) * kBlockGames;
+            long long last = std::min(first + kBlockGames, config.games);
+            Totals& t = blockTotals[static_cast<std::size_t>(b)];
+            for (long long g = first; g < last; ++g) {
+                t.add(playOne(config, v, g));
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream csv(config.outFile);
+    if (!csv) {
+        std::cerr << "no se pudo abrir " << config.outFile << "\n";
+        return 1;
+    }
+    csv << "layout,damageFactor,restitutionInfra,games,leftWins,rightWins,draws,"
+           "leftWinRate,avgShots,avgSteps,avgLeftDamage,avgRightDamage\n";
+    csv << std::setprecision(6);
+
+    std::cout << std::left << std::setw(9) << "nivel"
+              << std::right << std::setw(8) << "daño"
+              << std::setw(8) << "e"
+              << std::setw(10) << "gana izq"
+              << std::setw(10) << "gana der"
+              << std::setw(9) << "empates"
+              << std::setw(10) << "tiros" << "\n";
+    std::cout << std::fixed;
+
+    long long totalGames = 0;
+    long long totalSteps = 0;
+    for (std::size_t vi = 0; vi < variants.size(); ++vi) {
+        Totals t;
+        for (long long b = 0; b < blocksPerVariant; ++b) {
+            t.add(blockTotals[vi * blocksPerVariant + b]);
+        }
+        const Variant& v = variants[vi];
+        double n = static_cast<double>(t.games);
+        csv << v.layoutName << ',' << v.damageFactor << ',' << v.restitution << ','
+            << t.games << ',' << t.leftWins << ',' << t.rightWins << ','
+            << t.draws << ',' << t.leftWins / n << ',' << t.shots / n << ','
+            << t.steps / n << ',' << t.leftDamage / n << ','
+            << t.rightDamage / n << '\n';
+
+        std::cout << std::left << std::setw(9) << v.layoutName << std::right
+                  << std::setprecision(3) << std::setw(8) << v.damageFactor
+                  << std::setw(8) << v.restitution
+                  << std::setprecision(1)
+                  << std::setw(9) << 100.0 * t.leftWins / n << "%"
+                  << std::setw(9) << 100.0 * t.rightWins / n << "%"
+                  << std::setw(8) << 100.0 * t.draws / n << "%"
+                  << std::setw(10) << t.shots / n << "\n";
+        totalGames += t.games;
+        totalSteps += t.steps;
+    }
+
+    std::cout << totalGames << " partidas, " << totalSteps << " pasos en "
+              << std::setprecision(2) << seconds << " s con " << threads
+              << " hilos (" << std::setprecision(0)
+              << totalGames / std::max(seconds, 1e-9) << " partidas/s)\n";
+    return 0;
+}
@@ -0,0 +1,13 @@
+# Torneo sin interfaz: muchas partidas en paralelo para balancear el juego
+# (ver tournament/main.cpp)
+TEMPLATE = app
+CONFIG += console c++17 thread
+CONFIG -= app_bundle
+CONFIG -= qt
+
+TARGET = tournament
+
+include(../gamecore.pri)
+
+SOURCES += \
+        main.cpp